@@ -34,8 +34,6 @@
 #include <Intrepid2_HGRAD_WEDGE_C1_FEM.hpp>
 #include <Intrepid2_HGRAD_WEDGE_C2_FEM.hpp>
 
-#include <memory>
-
 namespace DataTransferKit
 {
 enum class FE {
@@ -237,140 +235,51 @@ struct DUMMY
 FE getFE( DTK_CellTopology topo, DTK_FEType fe_type );
 
 /**
- * Return the number of degrees of freedom per cell for a given
+ * Return the number of degrees of freedom per cell for a given finite element.
+ * The values are the cardinalities of the corresponding Intrepid2 bases.
  */
-template <typename DeviceType>
+KOKKOS_INLINE_FUNCTION
 unsigned int getCardinality( FE fe )
 {
-    typedef typename Kokkos::View<double *, DeviceType>::traits::execution_space
-        ExecutionSpace;
-    std::unique_ptr<Intrepid2::Basis<ExecutionSpace, double, double>> basis;
     switch ( fe )
     {
     case FE::HEX_HCURL_1:
-    {
-        basis.reset(
-            new HEX_HCURL_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 12;
     case FE::HEX_HDIV_1:
-    {
-        basis.reset(
-            new HEX_HDIV_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 6;
     case FE::HEX_HGRAD_1:
-    {
-        basis.reset(
-            new HEX_HGRAD_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 8;
     case FE::HEX_HGRAD_2:
-    {
-        basis.reset(
-            new HEX_HGRAD_2::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 27;
     case FE::PYR_HGRAD_1:
-    {
-        basis.reset(
-            new PYR_HGRAD_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 5;
     case FE::QUAD_HCURL_1:
-    {
-        basis.reset(
-            new QUAD_HCURL_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 4;
     case FE::QUAD_HDIV_1:
-    {
-        basis.reset(
-            new QUAD_HDIV_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 4;
     case FE::QUAD_HGRAD_1:
-    {
-        basis.reset(
-            new QUAD_HGRAD_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 4;
     case FE::QUAD_HGRAD_2:
-    {
-        basis.reset(
-            new QUAD_HGRAD_2::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 9;
     case FE::TET_HCURL_1:
-    {
-        basis.reset(
-            new QUAD_HCURL_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 6;
     case FE::TET_HDIV_1:
-    {
-        basis.reset(
-            new TET_HDIV_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 4;
     case FE::TET_HGRAD_1:
-    {
-        basis.reset(
-            new TET_HGRAD_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 4;
     case FE::TET_HGRAD_2:
-    {
-        basis.reset(
-            new TET_HGRAD_2::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 10;
     case FE::TRI_HGRAD_1:
-    {
-        basis.reset(
-            new TRI_HGRAD_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 3;
     case FE::TRI_HGRAD_2:
-    {
-        basis.reset(
-            new TRI_HGRAD_2::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 6;
     case FE::WEDGE_HGRAD_1:
-    {
-        basis.reset(
-            new WEDGE_HGRAD_1::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 6;
     case FE::WEDGE_HGRAD_2:
-    {
-        basis.reset(
-            new WEDGE_HGRAD_2::basis_type<ExecutionSpace, double, double>() );
-
-        break;
-    }
+        return 18;
     default:
         return 0;
     }
-
-    return basis->getCardinality();
 }
 } // namespace DataTransferKit
 
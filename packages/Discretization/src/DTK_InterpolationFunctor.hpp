@@ -12,100 +12,423 @@
 #ifndef DTK_INTERPOLATION_FUNCTOR_HPP
 #define DTK_INTERPOLATION_FUNCTOR_HPP
 
+#include <Kokkos_Core.hpp>
 #include <Kokkos_Macros.hpp>
 #include <Kokkos_View.hpp>
 
+#include <algorithm>
+
 namespace DataTransferKit
 {
 namespace Functor
 {
-template <typename Scalar, typename BasisType, typename DeviceType>
+namespace Details
+{
+/**
+ * Replace the gradients of the basis functions with respect to the reference
+ * coordinates by the gradients with respect to the physical coordinates,
+ * i.e., multiply them by the inverse of the transpose of the Jacobian of the
+ * map from the reference frame to the physical frame. The cells are
+ * isoparametric, so the Jacobian is computed using the same gradients.
+ */
+template <typename GradientsType, typename NodesType>
+KOKKOS_INLINE_FUNCTION void
+mapGradientsToPhysicalFrame( unsigned int const dim, GradientsType &gradients,
+                             NodesType const &nodes )
+{
+    unsigned int const n_basis = gradients.extent( 0 );
+    double jacobian[3][3] = {{0., 0., 0.}, {0., 0., 0.}, {0., 0., 0.}};
+    for ( unsigned int n = 0; n < n_basis; ++n )
+        for ( unsigned int d = 0; d < dim; ++d )
+            for ( unsigned int e = 0; e < dim; ++e )
+                jacobian[d][e] += nodes( n, d ) * gradients( n, e );
+
+    double inverse[3][3];
+    if ( dim == 2 )
+    {
+        double const det = jacobian[0][0] * jacobian[1][1] -
+                           jacobian[0][1] * jacobian[1][0];
+        inverse[0][0] = jacobian[1][1] / det;
+        inverse[0][1] = -jacobian[0][1] / det;
+        inverse[1][0] = -jacobian[1][0] / det;
+        inverse[1][1] = jacobian[0][0] / det;
+    }
+    else
+    {
+        // The inverse is the transpose of the cofactor matrix divided by the
+        // determinant.
+        for ( unsigned int d = 0; d < 3; ++d )
+            for ( unsigned int e = 0; e < 3; ++e )
+            {
+                unsigned int const d1 = ( e + 1 ) % 3;
+                unsigned int const d2 = ( e + 2 ) % 3;
+                unsigned int const e1 = ( d + 1 ) % 3;
+                unsigned int const e2 = ( d + 2 ) % 3;
+                inverse[d][e] = jacobian[d1][e1] * jacobian[d2][e2] -
+                                jacobian[d1][e2] * jacobian[d2][e1];
+            }
+        double const det = jacobian[0][0] * inverse[0][0] +
+                           jacobian[0][1] * inverse[1][0] +
+                           jacobian[0][2] * inverse[2][0];
+        for ( unsigned int d = 0; d < 3; ++d )
+            for ( unsigned int e = 0; e < 3; ++e )
+                inverse[d][e] /= det;
+    }
+
+    for ( unsigned int n = 0; n < n_basis; ++n )
+    {
+        double reference_gradient[3];
+        for ( unsigned int e = 0; e < dim; ++e )
+            reference_gradient[e] = gradients( n, e );
+        for ( unsigned int d = 0; d < dim; ++d )
+        {
+            gradients( n, d ) = 0.;
+            for ( unsigned int e = 0; e < dim; ++e )
+                gradients( n, d ) += inverse[e][d] * reference_gradient[e];
+        }
+    }
+}
+} // namespace Details
+
+/**
+ * Evaluate the basis functions of a vector-valued finite element (HDIV and
+ * HCURL) at the reference points. The components of each basis function are
+ * summed up.
+ */
+template <typename BasisType, typename DeviceType>
+class BasisValues
+{
+  public:
+    BasisValues( unsigned int const dim,
+                 Kokkos::View<Coordinate **, DeviceType> reference_points,
+                 Kokkos::View<Coordinate **, DeviceType> basis_values )
+        : _dim( dim )
+        , _n_basis( basis_values.extent( 1 ) )
+        , _vector_basis_values( "vector_basis_values",
+                                basis_values.extent( 0 ), _n_basis, dim )
+        , _reference_points( reference_points )
+        , _basis_values( basis_values )
+    {
+        DTK_REQUIRE( _basis_values.extent( 0 ) ==
+                     _reference_points.extent( 0 ) );
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()( int const i ) const
+    {
+        auto ref_point = Kokkos::subview( _reference_points, i, Kokkos::ALL() );
+        auto vector_basis_values = Kokkos::subview(
+            _vector_basis_values, i, Kokkos::ALL(), Kokkos::ALL() );
+        BasisType::getValues( vector_basis_values, ref_point );
+
+        for ( unsigned int j = 0; j < _n_basis; ++j )
+        {
+            _basis_values( i, j ) = 0.;
+            for ( unsigned int d = 0; d < _dim; ++d )
+                _basis_values( i, j ) += vector_basis_values( j, d );
+        }
+    }
+
+  private:
+    unsigned int const _dim;
+    unsigned int const _n_basis;
+    Kokkos::DynRankView<Coordinate, DeviceType> _vector_basis_values;
+    Kokkos::View<Coordinate **, DeviceType> _reference_points;
+    Kokkos::View<Coordinate **, DeviceType> _basis_values;
+};
+
+/**
+ * Evaluate the basis functions of a scalar finite element (HGRAD) at the
+ * reference points.
+ */
+template <typename BasisType, typename DeviceType>
+class HgradBasisValues
+{
+  public:
+    HgradBasisValues( Kokkos::View<Coordinate **, DeviceType> reference_points,
+                      Kokkos::View<Coordinate **, DeviceType> basis_values )
+        : _reference_points( reference_points )
+        , _basis_values( basis_values )
+    {
+        DTK_REQUIRE( _basis_values.extent( 0 ) ==
+                     _reference_points.extent( 0 ) );
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()( int const i ) const
+    {
+        auto ref_point = Kokkos::subview( _reference_points, i, Kokkos::ALL() );
+        auto basis_values = Kokkos::subview( _basis_values, i, Kokkos::ALL() );
+        BasisType::getValues( basis_values, ref_point );
+    }
+
+  private:
+    Kokkos::View<Coordinate **, DeviceType> _reference_points;
+    // We cannot use Scalar because in Basis_HGRAD_PYR_C1_FEM there is a
+    // check that basis_values and ref_point have the same type.
+    Kokkos::View<Coordinate **, DeviceType> _basis_values;
+};
+
+/**
+ * Evaluate the gradients, with respect to the physical coordinates, of the
+ * basis functions of a scalar finite element (HGRAD) at the reference points.
+ * The finite element uses the same basis functions as the map of the cell.
+ */
+template <typename CellType, typename DeviceType>
+class HgradBasisGradients
+{
+  public:
+    HgradBasisGradients(
+        Kokkos::View<Coordinate **, DeviceType> reference_points,
+        Kokkos::View<Coordinate ***, DeviceType> cells,
+        Kokkos::View<int *, DeviceType> cell_indices,
+        Kokkos::View<Coordinate ***, DeviceType> basis_gradients )
+        : _dim( reference_points.extent( 1 ) )
+        , _reference_points( reference_points )
+        , _cells( cells )
+        , _cell_indices( cell_indices )
+        , _basis_gradients( basis_gradients )
+    {
+        DTK_REQUIRE( _basis_gradients.extent( 0 ) ==
+                     _reference_points.extent( 0 ) );
+        DTK_REQUIRE( _basis_gradients.extent( 1 ) == _cells.extent( 1 ) );
+        DTK_REQUIRE( _basis_gradients.extent( 2 ) == _dim );
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()( int const i ) const
+    {
+        auto ref_point = Kokkos::subview( _reference_points, i, Kokkos::ALL() );
+        auto nodes = Kokkos::subview( _cells, _cell_indices( i ), Kokkos::ALL(),
+                                      Kokkos::ALL() );
+        auto gradients = Kokkos::subview( _basis_gradients, i, Kokkos::ALL(),
+                                          Kokkos::ALL() );
+        CellType::basis_type::template Serial<
+            Intrepid2::OPERATOR_GRAD>::getValues( gradients, ref_point );
+        Details::mapGradientsToPhysicalFrame( _dim, gradients, nodes );
+    }
+
+  private:
+    unsigned int const _dim;
+    Kokkos::View<Coordinate **, DeviceType> _reference_points;
+    Kokkos::View<Coordinate ***, DeviceType> _cells;
+    Kokkos::View<int *, DeviceType> _cell_indices;
+    Kokkos::View<Coordinate ***, DeviceType> _basis_gradients;
+};
+
+/**
+ * Interpolate the dof values using the basis values computed beforehand: the
+ * output is the sum over the basis functions of the cell of the basis values
+ * times the values of the associated dofs. The value of the i-th reference
+ * point is written in the row offset + i of the output. The basis values are
+ * stored with the same precision as the dof values.
+ */
+template <typename Scalar, typename DeviceType>
 class Interpolation
 {
   public:
-    Interpolation( unsigned int const dim,
-                   Kokkos::View<Coordinate **, DeviceType> reference_points,
+    Interpolation( Kokkos::View<Scalar **, DeviceType> basis_values,
                    Kokkos::View<LocalOrdinal **, DeviceType> cell_dofs_ids,
                    Kokkos::View<Scalar **, DeviceType> dof_values,
-                   Kokkos::View<Scalar **, DeviceType> output )
-        : _dim( dim )
-        , _n_basis( cell_dofs_ids.extent( 1 ) )
+                   Kokkos::View<Scalar **, DeviceType> output,
+                   unsigned int offset = 0 )
+        : _n_basis( cell_dofs_ids.extent( 1 ) )
         , _n_fields( dof_values.extent( 1 ) )
-        , _basis_values( "basis_values", output.extent( 0 ), _n_basis, dim )
-        , _reference_points( reference_points )
+        , _offset( offset )
+        , _basis_values( basis_values )
         , _cell_dofs_ids( cell_dofs_ids )
         , _dof_values( dof_values )
         , _output( output )
     {
         DTK_REQUIRE( _output.extent( 1 ) == dof_values.extent( 1 ) );
+        DTK_REQUIRE( _offset + _basis_values.extent( 0 ) <=
+                     _output.extent( 0 ) );
+        DTK_REQUIRE( _basis_values.extent( 1 ) == _n_basis );
     }
 
     KOKKOS_INLINE_FUNCTION
     void operator()( int const i ) const
     {
-        auto ref_point = Kokkos::subview( _reference_points, i, Kokkos::ALL() );
-        auto basis_values =
-            Kokkos::subview( _basis_values, i, Kokkos::ALL(), Kokkos::ALL() );
-        BasisType::getValues( basis_values, ref_point );
-
-        for ( unsigned int j = 0; j < _n_basis; ++j )
-            for ( unsigned int d = 0; d < _dim; ++d )
-                for ( unsigned int k = 0; k < _n_fields; ++k )
-                    _output( i, k ) += basis_values( j, d ) *
-                                       _dof_values( _cell_dofs_ids( i, j ), k );
+        for ( unsigned int k = 0; k < _n_fields; ++k )
+        {
+            Scalar value = 0.;
+            for ( unsigned int j = 0; j < _n_basis; ++j )
+                value += _basis_values( i, j ) *
+                         _dof_values( _cell_dofs_ids( i, j ), k );
+            _output( _offset + i, k ) = value;
+        }
     }
 
   private:
-    unsigned int const _dim;
     unsigned int const _n_basis;
     unsigned int const _n_fields;
-    Kokkos::DynRankView<Coordinate, DeviceType> _basis_values;
-    Kokkos::View<Coordinate **, DeviceType> _reference_points;
+    unsigned int const _offset;
+    Kokkos::View<Scalar **, DeviceType> _basis_values;
     Kokkos::View<LocalOrdinal **, DeviceType> _cell_dofs_ids;
     Kokkos::View<Scalar **, DeviceType> _dof_values;
     Kokkos::View<Scalar **, DeviceType> _output;
 };
 
-template <typename Scalar, typename BasisType, typename DeviceType>
-class HgradInterpolation
+/**
+ * Same as Interpolation but the gradients of the fields are computed together
+ * with their values. The row offset + i of the output contains the n_fields
+ * values of the i-th reference point followed by the dim components of the
+ * gradient of each field.
+ */
+template <typename Scalar, typename DeviceType>
+class ValueAndGradientInterpolation
 {
   public:
-    HgradInterpolation(
-        Kokkos::View<Coordinate **, DeviceType> reference_points,
+    ValueAndGradientInterpolation(
+        Kokkos::View<Coordinate **, DeviceType> basis_values,
+        Kokkos::View<Coordinate ***, DeviceType> basis_gradients,
         Kokkos::View<LocalOrdinal **, DeviceType> cell_dofs_ids,
         Kokkos::View<Scalar **, DeviceType> dof_values,
-        Kokkos::View<Scalar **, DeviceType> output )
+        Kokkos::View<Scalar **, DeviceType> output, unsigned int offset = 0 )
         : _n_basis( cell_dofs_ids.extent( 1 ) )
         , _n_fields( dof_values.extent( 1 ) )
-        , _basis_values( "basis_values", output.extent( 0 ), _n_basis )
-        , _reference_points( reference_points )
+        , _dim( basis_gradients.extent( 2 ) )
+        , _offset( offset )
+        , _basis_values( basis_values )
+        , _basis_gradients( basis_gradients )
         , _cell_dofs_ids( cell_dofs_ids )
         , _dof_values( dof_values )
         , _output( output )
     {
-        DTK_REQUIRE( _output.extent( 1 ) == dof_values.extent( 1 ) );
+        DTK_REQUIRE( _output.extent( 1 ) == _n_fields * ( 1 + _dim ) );
+        DTK_REQUIRE( _offset + _basis_values.extent( 0 ) <=
+                     _output.extent( 0 ) );
+        DTK_REQUIRE( _basis_values.extent( 1 ) == _n_basis );
+        DTK_REQUIRE( _basis_gradients.extent( 0 ) ==
+                     _basis_values.extent( 0 ) );
+        DTK_REQUIRE( _basis_gradients.extent( 1 ) == _n_basis );
     }
 
     KOKKOS_INLINE_FUNCTION
     void operator()( int const i ) const
     {
-        auto ref_point = Kokkos::subview( _reference_points, i, Kokkos::ALL() );
-        auto basis_values = Kokkos::subview( _basis_values, i, Kokkos::ALL() );
-        BasisType::getValues( basis_values, ref_point );
-
-        for ( unsigned int j = 0; j < _n_basis; ++j )
-            for ( unsigned int k = 0; k < _n_fields; ++k )
-                _output( i, k ) += basis_values( j ) *
-                                   _dof_values( _cell_dofs_ids( i, j ), k );
+        for ( unsigned int k = 0; k < _n_fields; ++k )
+        {
+            Scalar value = 0.;
+            Scalar gradient[3] = {0., 0., 0.};
+            for ( unsigned int j = 0; j < _n_basis; ++j )
+            {
+                Scalar const dof_value =
+                    _dof_values( _cell_dofs_ids( i, j ), k );
+                value += _basis_values( i, j ) * dof_value;
+                for ( unsigned int d = 0; d < _dim; ++d )
+                    gradient[d] += _basis_gradients( i, j, d ) * dof_value;
+            }
+            _output( _offset + i, k ) = value;
+            for ( unsigned int d = 0; d < _dim; ++d )
+                _output( _offset + i, _n_fields + k * _dim + d ) = gradient[d];
+        }
     }
 
   private:
-    unsigned int _n_basis;
-    unsigned int _n_fields;
-    // We cannot use Scalar because in Basis_HGRAD_PYR_C1_FEM there is a
-    // check that basis_values and ref_point have the same type.
+    unsigned int const _n_basis;
+    unsigned int const _n_fields;
+    unsigned int const _dim;
+    unsigned int const _offset;
     Kokkos::View<Coordinate **, DeviceType> _basis_values;
-    Kokkos::View<Coordinate **, DeviceType> _reference_points;
+    Kokkos::View<Coordinate ***, DeviceType> _basis_gradients;
+    Kokkos::View<LocalOrdinal **, DeviceType> _cell_dofs_ids;
+    Kokkos::View<Scalar **, DeviceType> _dof_values;
+    Kokkos::View<Scalar **, DeviceType> _output;
+};
+
+/**
+ * Same as Interpolation but a team of threads handles a block of reference
+ * points, one thread per point, and the fields are spread across the vector
+ * lanes. This is faster than Interpolation when the number of basis functions
+ * times the number of fields is large, e.g., for high order elements with
+ * many fields. The dof values are read directly from global memory: each of
+ * them is only used once by a point, so staging them in scratch memory would
+ * not save any load.
+ */
+template <typename Scalar, typename DeviceType>
+class TeamInterpolation
+{
+  public:
+    using ExecutionSpace = typename DeviceType::execution_space;
+    using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
+
+    TeamInterpolation( Kokkos::View<Scalar **, DeviceType> basis_values,
+                       Kokkos::View<LocalOrdinal **, DeviceType> cell_dofs_ids,
+                       Kokkos::View<Scalar **, DeviceType> dof_values,
+                       Kokkos::View<Scalar **, DeviceType> output,
+                       unsigned int offset = 0 )
+        : _n_points( basis_values.extent( 0 ) )
+        , _n_basis( cell_dofs_ids.extent( 1 ) )
+        , _n_fields( dof_values.extent( 1 ) )
+        , _offset( offset )
+        , _basis_values( basis_values )
+        , _cell_dofs_ids( cell_dofs_ids )
+        , _dof_values( dof_values )
+        , _output( output )
+    {
+        DTK_REQUIRE( _output.extent( 1 ) == dof_values.extent( 1 ) );
+        DTK_REQUIRE( _offset + _basis_values.extent( 0 ) <=
+                     _output.extent( 0 ) );
+        DTK_REQUIRE( _basis_values.extent( 1 ) == _n_basis );
+    }
+
+    /**
+     * Return the execution policy to use with this functor. The team size is
+     * the number of points per team, unless the backend cannot run teams
+     * that large.
+     */
+    TeamPolicy policy() const
+    {
+        // Use the smallest power of two larger than the number of fields
+        unsigned int const max_vector_length = TeamPolicy::vector_length_max();
+        unsigned int vector_length = 1;
+        while ( ( vector_length < _n_fields ) &&
+                ( 2 * vector_length <= max_vector_length ) )
+            vector_length *= 2;
+
+        unsigned int const max_points_per_team = 32;
+        unsigned int const max_team_size =
+            TeamPolicy( 1, 1, vector_length )
+                .team_size_max( *this, Kokkos::ParallelForTag() );
+        unsigned int const team_size =
+            std::max( 1u, std::min( max_points_per_team, max_team_size ) );
+        unsigned int const n_teams = ( _n_points + team_size - 1 ) / team_size;
+
+        return TeamPolicy( n_teams, team_size, vector_length );
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()( typename TeamPolicy::member_type const &team ) const
+    {
+        // Each thread of the team handles one point.
+        unsigned int const points_per_team = team.team_size();
+        unsigned int const first_point = team.league_rank() * points_per_team;
+        unsigned int const n_team_points =
+            ( first_point + points_per_team <= _n_points )
+                ? points_per_team
+                : _n_points - first_point;
+        Kokkos::parallel_for(
+            Kokkos::TeamThreadRange( team, n_team_points ), [&]( int const p ) {
+                int const i = first_point + p;
+                Kokkos::parallel_for(
+                    Kokkos::ThreadVectorRange( team, _n_fields ),
+                    [&]( int const k ) {
+                        Scalar value = 0.;
+                        for ( unsigned int j = 0; j < _n_basis; ++j )
+                            value += _basis_values( i, j ) *
+                                     _dof_values( _cell_dofs_ids( i, j ), k );
+                        _output( _offset + i, k ) = value;
+                    } );
+            } );
+    }
+
+  private:
+    unsigned int const _n_points;
+    unsigned int const _n_basis;
+    unsigned int const _n_fields;
+    unsigned int const _offset;
+    Kokkos::View<Scalar **, DeviceType> _basis_values;
     Kokkos::View<LocalOrdinal **, DeviceType> _cell_dofs_ids;
     Kokkos::View<Scalar **, DeviceType> _dof_values;
     Kokkos::View<Scalar **, DeviceType> _output;
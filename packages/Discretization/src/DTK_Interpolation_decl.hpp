@@ -14,6 +14,7 @@
 
 #include "DTK_ConfigDefs.hpp"
 #include <ArborX.hpp>
+#include <DTK_DetailsDistributor.hpp>
 #include <DTK_FE.hpp>
 #include <DTK_FETypes.h>
 #include <DTK_InterpolationFunctor.hpp>
@@ -32,7 +33,10 @@ namespace DataTransferKit
 {
 /**
  * This class performs an interpolation for a set of given points in a given
- * mesh.
+ * mesh. The search and the setup are always done in double precision but the
+ * interpolation can be applied to double or float values. In the latter case,
+ * the basis values are also cached in single precision so that both the
+ * values communicated and the basis values read are half the size.
  */
 template <typename DeviceType>
 class Interpolation
@@ -54,6 +58,31 @@ class Interpolation
                    Kokkos::View<LocalOrdinal *, DeviceType> cell_dof_ids,
                    DTK_FEType fe_type );
 
+    /**
+     * Constructor using a search index that has already been built for the
+     * mesh.
+     * @param mesh_index search index of the domain of interest
+     * @param points_coordinates coordinates in the physical frame of the points
+     * that we are looking for (n phys points, dim)
+     * @param cell_dof_ids degrees of freedom indices associated to each cell (n
+     * cells * n dofs per cell)
+     * @param fe_type type of the finite element (DTK_HGRAD, DTK_HDIV, or
+     * DTK_CURL)
+     */
+    Interpolation( MeshSearchIndex<DeviceType> const &mesh_index,
+                   Kokkos::View<double **, DeviceType> points_coordinates,
+                   Kokkos::View<LocalOrdinal *, DeviceType> cell_dof_ids,
+                   DTK_FEType fe_type );
+
+    /**
+     * Update the interpolation after the points have moved. Only the points
+     * that left the cells where they were previously found are searched for
+     * again.
+     * @param points_coordinates new coordinates in the physical frame of the
+     * points (n phys points, dim)
+     */
+    void update( Kokkos::View<double **, DeviceType> points_coordinates );
+
     /**
      * This function performs the interpolation.
      * @param [in] X (n dofs, n fields)
@@ -67,35 +96,161 @@ class Interpolation
     apply( Kokkos::View<Scalar **, DeviceType> X,
            Kokkos::View<Scalar **, DeviceType> Y );
 
-  private:
+    /**
+     * This function starts the interpolation: the values at the points are
+     * computed and their communication is posted. The values of the points
+     * that were found on this processor are written in Y right away. Other
+     * computations can be done until applyEnd() is called but Y must not be
+     * used and no other interpolation can be applied in between.
+     * @param [in] X (n dofs, n fields)
+     * @param [out] Y (n phys points, n fields)
+     */
+    template <typename Scalar>
+    void applyBegin( Kokkos::View<Scalar **, DeviceType> X,
+                     Kokkos::View<Scalar **, DeviceType> Y );
+
+    /**
+     * This function waits for the values posted by applyBegin() and completes
+     * Y.
+     * @param [out] Y (n phys points, n fields), the View given to
+     * applyBegin()
+     * @return View of size Y.extent(0) with the ID associated associated to
+     * each physical points.
+     */
+    template <typename Scalar>
+    Kokkos::View<int *, DeviceType>
+    applyEnd( Kokkos::View<Scalar **, DeviceType> Y );
+
+    /**
+     * This function performs the interpolation of the fields and of their
+     * gradients with a single communication. This is only available for
+     * HGRAD finite elements.
+     * @param [in] X (n dofs, n fields)
+     * @param [out] Y (n phys points, n fields)
+     * @param [out] grad_Y (n phys points, n fields, dim)
+     * @return View of size Y.extent(0) with the ID associated associated to
+     * each physical points. This can be used to know if a point was not found
+     * and which one it was.
+     */
+    template <typename Scalar>
+    Kokkos::View<int *, DeviceType>
+    apply( Kokkos::View<Scalar **, DeviceType> X,
+           Kokkos::View<Scalar **, DeviceType> Y,
+           Kokkos::View<Scalar ***, DeviceType> grad_Y );
+
+    /**
+     * This function applies the transpose of the interpolation operator. The
+     * values at the points are sent back to the processors owning the cells
+     * where the points were found. There, the values weighted by the basis
+     * functions are added to the dofs of these cells.
+     * @param [in] Y (n phys points, n fields) with the same layout as the
+     * output of apply()
+     * @param [in,out] X (n dofs, n fields)
+     */
+    template <typename Scalar>
+    void applyTranspose( Kokkos::View<Scalar **, DeviceType> Y,
+                         Kokkos::View<Scalar **, DeviceType> X );
+
+    /**
+     * Build the distributor used by applyTranspose() and compute
+     * _transpose_positions. This is only done the first time
+     * applyTranspose() is called after the search changed.
+     *
+     * @note This function should be <b>private</b> but lambda functions can
+     * only be called from a public function in CUDA.
+     */
+    void buildTransposeDistributor();
+
+    /**
+     * Send the query ids of the results to the processors owning the points
+     * and compute _found_imports and _found_query_ids. The query ids do not
+     * change between two calls to apply() so this is only done when the
+     * search changes.
+     *
+     * @note This function should be <b>private</b> but lambda functions can
+     * only be called from a public function in CUDA.
+     */
+    void buildQueryIdsBuffers();
+
+    /**
+     * Convert the basis values to single precision and store them in
+     * _basis_values_float. This is only done the first time the
+     * interpolation is applied to float values after the search changed.
+     *
+     * @note This function should be <b>private</b> but lambda functions can
+     * only be called from a public function in CUDA.
+     */
+    void computeSinglePrecisionBasisValues();
+
+    /**
+     * Gather the degrees of freedom indices of the cells where the points were
+     * found and store them in _dofs_ids.
+     *
+     * @note This function should be <b>private</b> but lambda functions can
+     * only be called from a public function in CUDA.
+     */
     void filter_dofs_ids(
         Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies,
         Kokkos::View<LocalOrdinal *, DeviceType> cell_dof_ids,
         DTK_FEType fe_type );
 
+  private:
+    /**
+     * Evaluate the basis functions at the reference points of every topology
+     * and store them in _basis_values.
+     */
+    void computeBasisValues();
+
     /**
-     * Helper function that calls Functor::Interpolation.
+     * Helper function that calls Functor::BasisValues.
      */
-    template <typename Scalar, typename FEOpType>
-    void interpolate( Kokkos::View<Coordinate **, DeviceType> ref_points,
-                      Kokkos::View<LocalOrdinal **, DeviceType> cell_dofs_ids,
-                      Kokkos::View<Scalar **, DeviceType> X,
-                      Kokkos::View<Scalar **, DeviceType> Y );
+    template <typename FEOpType>
+    void
+    vectorBasisValues( Kokkos::View<Coordinate **, DeviceType> ref_points,
+                       Kokkos::View<Coordinate **, DeviceType> basis_values );
 
     /**
-     * Helper function that calls Functor::HgradInterpolation.
+     * Helper function that calls Functor::HgradBasisValues.
      */
-    template <typename Scalar, typename FEOpType>
+    template <typename FEOpType>
     void
-    hgradInterpolate( Kokkos::View<Coordinate **, DeviceType> ref_points,
-                      Kokkos::View<LocalOrdinal **, DeviceType> cell_dofs_ids,
-                      Kokkos::View<Scalar **, DeviceType> X,
-                      Kokkos::View<Scalar **, DeviceType> Y );
+    hgradBasisValues( Kokkos::View<Coordinate **, DeviceType> ref_points,
+                      Kokkos::View<Coordinate **, DeviceType> basis_values );
+
+    void basisValuesDispatch( FE fe, unsigned int topo_id );
+
+    /**
+     * Return the basis values with the precision of the values interpolated.
+     */
+    std::array<Kokkos::View<Coordinate **, DeviceType>, DTK_N_TOPO> const &
+    getBasisValues( double );
 
+    std::array<Kokkos::View<float **, DeviceType>, DTK_N_TOPO> const &
+    getBasisValues( float );
+
+    /**
+     * Evaluate the gradients of the basis functions at the reference points of
+     * every topology and store them in _basis_gradients. The gradients are
+     * only computed the first time they are needed.
+     */
+    void computeBasisGradients();
+
+    /**
+     * Helper function that calls Functor::HgradBasisGradients.
+     */
+    template <typename CellType>
+    void hgradBasisGradients( unsigned int topo_id );
+
+    void basisGradientsDispatch( DTK_CellTopology topo, unsigned int topo_id );
+
+    /**
+     * Return a View of size (n_rows, n_fields) using the memory of buffer.
+     * The buffer is only reallocated when it is too small.
+     */
     template <typename Scalar>
-    void interpolateDispatch( FE fe, unsigned int fe_id,
-                              Kokkos::View<Scalar **, DeviceType> X,
-                              Kokkos::View<Scalar **, DeviceType> Y_fe );
+    static Kokkos::View<Scalar **, DeviceType>
+    getBuffer( Kokkos::View<char *, DeviceType> &buffer, unsigned int n_rows,
+               unsigned int n_fields );
 
     PointSearch<DeviceType> _point_search;
 
@@ -108,25 +263,123 @@ class Interpolation
      * Map between the finite element index and the finite element basis.
      */
     std::array<FE, DTK_N_TOPO> _finite_elements;
+
+    /**
+     * Values of the basis functions at the reference points (n reference
+     * points, n basis functions). The reference points do not change between
+     * two calls to apply() so the basis functions are only evaluated once.
+     */
+    std::array<Kokkos::View<Coordinate **, DeviceType>, DTK_N_TOPO>
+        _basis_values;
+
+    /**
+     * Single precision copy of _basis_values used to interpolate float
+     * values.
+     */
+    std::array<Kokkos::View<float **, DeviceType>, DTK_N_TOPO>
+        _basis_values_float;
+    bool _have_basis_values_float = false;
+
+    /**
+     * Gradients of the basis functions with respect to the physical
+     * coordinates at the reference points (n reference points, n basis
+     * functions, dim). They are only used to interpolate the gradients of the
+     * fields.
+     */
+    std::array<Kokkos::View<Coordinate ***, DeviceType>, DTK_N_TOPO>
+        _basis_gradients;
+    bool _have_basis_gradients = false;
+
+    /**
+     * Degrees of freedom indices and finite element type given to the
+     * constructor. They are needed to update the interpolation.
+     */
+    Kokkos::View<LocalOrdinal *, DeviceType> _cell_dof_ids;
+    DTK_FEType _fe_type;
+
+    /**
+     * Distributor sending the values of the points to the processors owning
+     * them. Contrary to the distributor of the search, it can overlap the
+     * communication with computations.
+     */
+    Details::Distributor<DeviceType> _distributor;
+
+    /**
+     * For each point that was found, in the order of the queries, position of
+     * its value in the values received by apply() (n found points).
+     */
+    Kokkos::View<unsigned int *, DeviceType> _found_imports;
+
+    /**
+     * Query ids of the points that were found, padded with -1 (n phys points).
+     */
+    Kokkos::View<int *, DeviceType> _found_query_ids;
+
+    /**
+     * For each value received by apply(), rank of the processor that sent it
+     * and position of the value in the values sent.
+     */
+    Kokkos::View<int *, DeviceType> _imported_cell_ranks;
+    Kokkos::View<int *, DeviceType> _imported_indices;
+
+    /**
+     * Distributor sending the values of the points back to the processors
+     * owning the cells and, for each result of the search, position of its
+     * value in the values received. They are used by applyTranspose().
+     */
+    ArborX::Details::Distributor<DeviceType> _transpose_distributor;
+    Kokkos::View<unsigned int *, DeviceType> _transpose_positions;
+    bool _have_transpose_distributor = false;
+
+    /**
+     * Memory reused by apply() and applyTranspose() for the values sent to and
+     * received from the other processors.
+     */
+    Kokkos::View<char *, DeviceType> _send_buffer;
+    Kokkos::View<char *, DeviceType> _receive_buffer;
 };
 
 template <typename DeviceType>
 template <typename Scalar>
-Kokkos::View<int *, DeviceType>
-Interpolation<DeviceType>::apply( Kokkos::View<Scalar **, DeviceType> X,
-                                  Kokkos::View<Scalar **, DeviceType> Y )
+Kokkos::View<Scalar **, DeviceType>
+Interpolation<DeviceType>::getBuffer( Kokkos::View<char *, DeviceType> &buffer,
+                                      unsigned int n_rows,
+                                      unsigned int n_fields )
+{
+    std::size_t const size =
+        static_cast<std::size_t>( n_rows ) * n_fields * sizeof( Scalar );
+    if ( buffer.extent( 0 ) < size )
+        Kokkos::realloc( buffer, size );
+
+    return Kokkos::View<Scalar **, DeviceType>(
+        reinterpret_cast<Scalar *>( buffer.data() ), n_rows, n_fields );
+}
+
+template <typename DeviceType>
+template <typename Scalar>
+void Interpolation<DeviceType>::applyBegin(
+    Kokkos::View<Scalar **, DeviceType> X,
+    Kokkos::View<Scalar **, DeviceType> Y )
 {
     // Check that the input and the output have the same number of fields
     DTK_REQUIRE( X.extent( 1 ) == Y.extent( 1 ) );
+    DTK_REQUIRE( Y.extent( 0 ) == _found_query_ids.extent( 0 ) );
     using ExecutionSpace = typename DeviceType::execution_space;
     unsigned int const n_fields = X.extent( 1 );
-    // Allocate a View that will be used as buffer for the MPI communication
+    unsigned int const team_interpolation_threshold = 64;
     unsigned int n_local_ref_pts = 0;
     for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
         n_local_ref_pts += _point_search._reference_points[topo_id].extent( 0 );
-    Kokkos::View<Scalar **, DeviceType> Y_buffer( "Y_buffer", n_local_ref_pts,
-                                                  n_fields );
-
+    unsigned int const n_imports = _distributor.getTotalReceiveLength();
+    Kokkos::View<Scalar **, DeviceType> Y_buffer =
+        getBuffer<Scalar>( _send_buffer, n_local_ref_pts, n_fields );
+    Kokkos::View<Scalar **, DeviceType> imported_Y =
+        getBuffer<Scalar>( _receive_buffer, n_imports, n_fields );
+    auto const &basis_values = getBasisValues( Scalar() );
+
+    // Perform the interpolation itself. The results of each topology are
+    // written directly at their place in the buffer sent to the processors
+    // owning the points.
     unsigned int offset = 0;
     for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
     {
@@ -135,288 +388,251 @@ Interpolation<DeviceType>::apply( Kokkos::View<Scalar **, DeviceType> X,
 
         if ( n_ref_points != 0 )
         {
-            // Perform the interpolation itself
-            Kokkos::View<Scalar **, DeviceType> Y_fe(
-                "Y_fe_" + std::to_string( topo_id ), n_ref_points, n_fields );
-            interpolateDispatch( _finite_elements[topo_id], topo_id, X, Y_fe );
-
-            // Put Y_fe in the right place in the buffer
-            Kokkos::parallel_for(
-                DTK_MARK_REGION( "fill_buffer" ),
-                Kokkos::RangePolicy<ExecutionSpace>( 0, n_ref_points ),
-                KOKKOS_LAMBDA( int const i ) {
-                    for ( unsigned int j = 0; j < n_fields; ++j )
-                        Y_buffer( offset + i, j ) = Y_fe( i, j );
-                } );
+            // With many basis functions and many fields, a single thread per
+            // point has too much serial work. A team of threads is then used
+            // for a block of points and the fields are spread across the
+            // vector lanes.
+            unsigned int const n_basis = _dofs_ids[topo_id].extent( 1 );
+            if ( n_basis * n_fields >= team_interpolation_threshold )
+            {
+                Functor::TeamInterpolation<Scalar, DeviceType>
+                    interpolation_functor( basis_values[topo_id],
+                                           _dofs_ids[topo_id], X, Y_buffer,
+                                           offset );
+                Kokkos::parallel_for( DTK_MARK_REGION( "team_interpolate" ),
+                                      interpolation_functor.policy(),
+                                      interpolation_functor );
+            }
+            else
+            {
+                Functor::Interpolation<Scalar, DeviceType>
+                    interpolation_functor( basis_values[topo_id],
+                                           _dofs_ids[topo_id], X, Y_buffer,
+                                           offset );
+                Kokkos::parallel_for(
+                    DTK_MARK_REGION( "interpolate" ),
+                    Kokkos::RangePolicy<ExecutionSpace>( 0, n_ref_points ),
+                    interpolation_functor );
+            }
             Kokkos::fence();
             offset += n_ref_points;
         }
     }
 
-    // Communicate the results, i.e, Y and the associated query ids
-    Kokkos::View<unsigned int *, DeviceType> query_ids( "query_ids",
-                                                        n_local_ref_pts );
-    unsigned int n_copied_pts = 0;
-    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
-    {
-        unsigned int const size = _point_search._query_ids[topo_id].extent( 0 );
-        auto topo_query_ids = _point_search._query_ids[topo_id];
-        Kokkos::parallel_for( DTK_MARK_REGION( "query_ids" ),
-                              Kokkos::RangePolicy<ExecutionSpace>( 0, size ),
-                              KOKKOS_LAMBDA( int const i ) {
-                                  query_ids( i + n_copied_pts ) =
-                                      topo_query_ids( i );
-                              } );
-        Kokkos::fence();
-
-        n_copied_pts += size;
-    }
-    unsigned int n_imports =
-        _point_search._target_to_source_distributor.getTotalReceiveLength();
-    Kokkos::View<unsigned int *, DeviceType> imported_query_ids(
-        "imported_query_ids", n_imports );
-    Kokkos::View<Scalar **, DeviceType> imported_Y( "imported_Y", n_imports,
-                                                    n_fields );
-    ArborX::Details::DistributedSearchTreeImpl<DeviceType>::sendAcrossNetwork(
-        _point_search._target_to_source_distributor, query_ids,
-        imported_query_ids );
-    ArborX::Details::DistributedSearchTreeImpl<DeviceType>::sendAcrossNetwork(
-        _point_search._target_to_source_distributor, Y_buffer, imported_Y );
+    // Post the communication of the results. The values of the points owned
+    // by this processor do not go through MPI and can be used right away.
+    _distributor.doPosts( Y_buffer, imported_Y );
 
-    Kokkos::View<int *, DeviceType> found_query_ids( "found_query_ids",
-                                                     Y.extent( 0 ) );
-    Kokkos::deep_copy( found_query_ids, -1 );
-
-    if ( n_imports != 0 )
-    {
-        // Because of the MPI communications and the sorting by topologies, all
-        // the queries have been reordered. So we put them back in the initial
-        // order using the query ids.
-        ArborX::Details::DistributedSearchTreeImpl<DeviceType>::sortResults(
-            imported_query_ids, imported_query_ids, imported_Y );
-
-        // We have finally all the values in the right order but before we can
-        // finally return the values we need to filter the data one more time.
-        // Some points are correctly found on multiple cells, e.g., point on
-        // vertices, so we need to get rid of the duplicates.
-        Kokkos::View<unsigned int *, DeviceType> mask( "mask", n_imports );
-        Kokkos::deep_copy( mask, 1 );
-        Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_mask" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 1, n_imports ),
-            KOKKOS_LAMBDA( int const i ) {
-                if ( imported_query_ids( i - 1 ) == imported_query_ids( i ) )
-                    mask( i ) = 0;
-            } );
-        Kokkos::fence();
-
-        Kokkos::View<unsigned int *, DeviceType> query_offset( "query_offset",
-                                                               n_imports );
-        ArborX::exclusivePrefixSum( mask, query_offset );
-
-        Kokkos::parallel_for(
-            DTK_MARK_REGION( "fill_Y" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
-            KOKKOS_LAMBDA( int const i ) {
-                if ( ( i == 0 ) || ( imported_query_ids( i - 1 ) !=
-                                     imported_query_ids( i ) ) )
-                {
-                    unsigned int k = query_offset( i );
-                    for ( unsigned int j = 0; j < n_fields; ++j )
-                        Y( k, j ) = imported_Y( i, j );
-                    found_query_ids( k ) = imported_query_ids( i );
-                }
-            } );
-        Kokkos::fence();
-    }
-
-    return found_query_ids;
+    auto const self_range = _distributor.getSelfReceiveRange();
+    unsigned int const self_first = self_range.first;
+    unsigned int const self_last = self_range.second;
+    Kokkos::View<unsigned int *, DeviceType> found_imports = _found_imports;
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "fill_local_Y" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, found_imports.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const k ) {
+            unsigned int const i = found_imports( k );
+            if ( i >= self_first && i < self_last )
+                for ( unsigned int j = 0; j < n_fields; ++j )
+                    Y( k, j ) = imported_Y( i, j );
+        } );
+    Kokkos::fence();
 }
 
 template <typename DeviceType>
-template <typename Scalar, typename FEOpType>
-void Interpolation<DeviceType>::interpolate(
-    Kokkos::View<Coordinate **, DeviceType> ref_points,
-    Kokkos::View<LocalOrdinal **, DeviceType> cell_dofs_ids,
-    Kokkos::View<Scalar **, DeviceType> X,
-    Kokkos::View<Scalar **, DeviceType> Y_fe )
+template <typename Scalar>
+Kokkos::View<int *, DeviceType>
+Interpolation<DeviceType>::applyEnd( Kokkos::View<Scalar **, DeviceType> Y )
 {
+    DTK_REQUIRE( Y.extent( 0 ) == _found_query_ids.extent( 0 ) );
     using ExecutionSpace = typename DeviceType::execution_space;
-    Functor::Interpolation<Scalar, FEOpType, DeviceType> interpolation_functor(
-        _point_search._dim, ref_points, cell_dofs_ids, X, Y_fe );
+    unsigned int const n_fields = Y.extent( 1 );
+    unsigned int const n_imports = _distributor.getTotalReceiveLength();
+    Kokkos::View<Scalar **, DeviceType> imported_Y =
+        getBuffer<Scalar>( _receive_buffer, n_imports, n_fields );
+
+    _distributor.doWaits( imported_Y );
+
+    // Put the values of the points that have been found on the other
+    // processors in the order of the queries.
+    auto const self_range = _distributor.getSelfReceiveRange();
+    unsigned int const self_first = self_range.first;
+    unsigned int const self_last = self_range.second;
+    Kokkos::View<unsigned int *, DeviceType> found_imports = _found_imports;
     Kokkos::parallel_for(
-        DTK_MARK_REGION( "interpolate" ),
-        Kokkos::RangePolicy<ExecutionSpace>( 0, ref_points.extent( 0 ) ),
-        interpolation_functor );
+        DTK_MARK_REGION( "fill_Y" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, found_imports.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const k ) {
+            unsigned int const i = found_imports( k );
+            if ( i < self_first || i >= self_last )
+                for ( unsigned int j = 0; j < n_fields; ++j )
+                    Y( k, j ) = imported_Y( i, j );
+        } );
+    Kokkos::fence();
+
+    return _found_query_ids;
 }
 
 template <typename DeviceType>
-template <typename Scalar, typename FEOpType>
-void Interpolation<DeviceType>::hgradInterpolate(
-    Kokkos::View<Coordinate **, DeviceType> ref_points,
-    Kokkos::View<LocalOrdinal **, DeviceType> cell_dofs_ids,
-    Kokkos::View<Scalar **, DeviceType> X,
-    Kokkos::View<Scalar **, DeviceType> Y_fe )
+template <typename Scalar>
+Kokkos::View<int *, DeviceType>
+Interpolation<DeviceType>::apply( Kokkos::View<Scalar **, DeviceType> X,
+                                  Kokkos::View<Scalar **, DeviceType> Y )
 {
-    using ExecutionSpace = typename DeviceType::execution_space;
-    Functor::HgradInterpolation<Scalar, FEOpType, DeviceType>
-        interpolation_functor( ref_points, cell_dofs_ids, X, Y_fe );
-    Kokkos::parallel_for(
-        DTK_MARK_REGION( "interpolate" ),
-        Kokkos::RangePolicy<ExecutionSpace>( 0, ref_points.extent( 0 ) ),
-        interpolation_functor );
+    applyBegin( X, Y );
+
+    return applyEnd( Y );
 }
 
 template <typename DeviceType>
 template <typename Scalar>
-void Interpolation<DeviceType>::interpolateDispatch(
-    FE fe, unsigned int topo_id, Kokkos::View<Scalar **, DeviceType> X,
-    Kokkos::View<Scalar **, DeviceType> Y_fe )
+Kokkos::View<int *, DeviceType>
+Interpolation<DeviceType>::apply( Kokkos::View<Scalar **, DeviceType> X,
+                                  Kokkos::View<Scalar **, DeviceType> Y,
+                                  Kokkos::View<Scalar ***, DeviceType> grad_Y )
 {
+    DTK_REQUIRE( _fe_type == DTK_HGRAD );
+    DTK_REQUIRE( X.extent( 1 ) == Y.extent( 1 ) );
+    DTK_REQUIRE( Y.extent( 0 ) == _found_query_ids.extent( 0 ) );
+    DTK_REQUIRE( grad_Y.extent( 0 ) == Y.extent( 0 ) );
+    DTK_REQUIRE( grad_Y.extent( 1 ) == Y.extent( 1 ) );
+    DTK_REQUIRE( grad_Y.extent( 2 ) == _point_search._dim );
+    using ExecutionSpace = typename DeviceType::execution_space;
+    if ( !_have_basis_gradients )
+        computeBasisGradients();
 
-    switch ( fe )
-    {
-    case FE::HEX_HCURL_1:
-    {
-        interpolate<Scalar, HEX_HCURL_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
-
-        break;
-    }
-    case FE::HEX_HDIV_1:
-    {
-        interpolate<Scalar, HEX_HDIV_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
-
-        break;
-    }
-    case FE::HEX_HGRAD_1:
-    {
-        hgradInterpolate<Scalar, HEX_HGRAD_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
-
-        break;
-    }
-    case FE::HEX_HGRAD_2:
-    {
-        hgradInterpolate<Scalar, HEX_HGRAD_2::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
-
-        break;
-    }
-    case FE::PYR_HGRAD_1:
-    {
-        hgradInterpolate<Scalar, PYR_HGRAD_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
-
-        break;
-    }
-    case FE::QUAD_HCURL_1:
-    {
-        interpolate<Scalar, QUAD_HCURL_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
-
-        break;
-    }
-    case FE::QUAD_HDIV_1:
-    {
-        interpolate<Scalar, QUAD_HDIV_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
-
-        break;
-    }
-    case FE::QUAD_HGRAD_1:
-    {
-        hgradInterpolate<Scalar, QUAD_HGRAD_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
-
-        break;
-    }
-    case FE::QUAD_HGRAD_2:
-    {
-        hgradInterpolate<Scalar, QUAD_HGRAD_2::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
+    // The values and the gradients are sent together: each row of the
+    // buffers contains the values of the fields followed by their gradients.
+    unsigned int const n_fields = X.extent( 1 );
+    unsigned int const dim = _point_search._dim;
+    unsigned int const row_size = n_fields * ( 1 + dim );
+    unsigned int n_local_ref_pts = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+        n_local_ref_pts += _point_search._reference_points[topo_id].extent( 0 );
+    unsigned int const n_imports = _distributor.getTotalReceiveLength();
+    Kokkos::View<Scalar **, DeviceType> Y_buffer =
+        getBuffer<Scalar>( _send_buffer, n_local_ref_pts, row_size );
+    Kokkos::View<Scalar **, DeviceType> imported_Y =
+        getBuffer<Scalar>( _receive_buffer, n_imports, row_size );
 
-        break;
-    }
-    case FE::TET_HCURL_1:
+    unsigned int offset = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
     {
-        interpolate<Scalar, TET_HCURL_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
+        unsigned int const n_ref_points =
+            _point_search._reference_points[topo_id].extent( 0 );
 
-        break;
+        if ( n_ref_points != 0 )
+        {
+            Functor::ValueAndGradientInterpolation<Scalar, DeviceType>
+                interpolation_functor(
+                    _basis_values[topo_id], _basis_gradients[topo_id],
+                    _dofs_ids[topo_id], X, Y_buffer, offset );
+            Kokkos::parallel_for(
+                DTK_MARK_REGION( "interpolate_value_and_gradient" ),
+                Kokkos::RangePolicy<ExecutionSpace>( 0, n_ref_points ),
+                interpolation_functor );
+            Kokkos::fence();
+            offset += n_ref_points;
+        }
     }
-    case FE::TET_HDIV_1:
-    {
-        interpolate<Scalar, TET_HDIV_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
 
-        break;
-    }
-    case FE::TET_HGRAD_1:
-    {
-        hgradInterpolate<Scalar, TET_HGRAD_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
+    // Communicate the results
+    _distributor.doPostsAndWaits( Y_buffer, imported_Y );
 
-        break;
-    }
-    case FE::TET_HGRAD_2:
-    {
-        hgradInterpolate<Scalar, TET_HGRAD_2::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
+    // Put the values and the gradients of the points that have been found in
+    // the order of the queries.
+    Kokkos::View<unsigned int *, DeviceType> found_imports = _found_imports;
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "fill_Y_and_grad_Y" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, found_imports.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const k ) {
+            unsigned int const i = found_imports( k );
+            for ( unsigned int j = 0; j < n_fields; ++j )
+            {
+                Y( k, j ) = imported_Y( i, j );
+                for ( unsigned int d = 0; d < dim; ++d )
+                    grad_Y( k, j, d ) = imported_Y( i, n_fields + j * dim + d );
+            }
+        } );
+    Kokkos::fence();
 
-        break;
-    }
-    case FE::TRI_HGRAD_1:
-    {
-        hgradInterpolate<Scalar, TRI_HGRAD_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
+    return _found_query_ids;
+}
 
-        break;
-    }
-    case FE::TRI_HGRAD_2:
-    {
-        hgradInterpolate<Scalar, TRI_HGRAD_2::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
+template <typename DeviceType>
+template <typename Scalar>
+void Interpolation<DeviceType>::applyTranspose(
+    Kokkos::View<Scalar **, DeviceType> Y,
+    Kokkos::View<Scalar **, DeviceType> X )
+{
+    DTK_REQUIRE( X.extent( 1 ) == Y.extent( 1 ) );
+    DTK_REQUIRE( Y.extent( 0 ) == _found_query_ids.extent( 0 ) );
+    using ExecutionSpace = typename DeviceType::execution_space;
+    if ( !_have_transpose_distributor )
+        buildTransposeDistributor();
+
+    // The buffers are used in the opposite direction of apply()
+    unsigned int const n_fields = Y.extent( 1 );
+    unsigned int const n_imports = _imported_indices.extent( 0 );
+    unsigned int const n_local_ref_pts = _transpose_positions.extent( 0 );
+    Kokkos::View<Scalar **, DeviceType> Y_buffer =
+        getBuffer<Scalar>( _receive_buffer, n_imports, n_fields );
+    Kokkos::View<Scalar **, DeviceType> imported_Y =
+        getBuffer<Scalar>( _send_buffer, n_local_ref_pts, n_fields );
+
+    // Only the values that apply() used are sent back, the other ones are
+    // zero.
+    Kokkos::deep_copy( Y_buffer, 0. );
+    Kokkos::View<unsigned int *, DeviceType> found_imports = _found_imports;
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "fill_Y_buffer" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, found_imports.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const k ) {
+            unsigned int const i = found_imports( k );
+            for ( unsigned int j = 0; j < n_fields; ++j )
+                Y_buffer( i, j ) = Y( k, j );
+        } );
+    Kokkos::fence();
 
-        break;
-    }
-    case FE::WEDGE_HGRAD_1:
-    {
-        hgradInterpolate<Scalar, WEDGE_HGRAD_1::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
+    // Communicate the values
+    ArborX::Details::DistributedSearchTreeImpl<DeviceType>::sendAcrossNetwork(
+        _transpose_distributor, Y_buffer, imported_Y );
 
-        break;
-    }
-    case FE::WEDGE_HGRAD_2:
+    // Several points may be in the same cell and several cells share the
+    // same dofs, so the contributions are added atomically.
+    Kokkos::View<unsigned int *, DeviceType> transpose_positions =
+        _transpose_positions;
+    unsigned int offset = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
     {
-        hgradInterpolate<Scalar, WEDGE_HGRAD_2::feop_type>(
-            _point_search._reference_points[topo_id], _dofs_ids[topo_id], X,
-            Y_fe );
+        unsigned int const n_ref_points =
+            _point_search._reference_points[topo_id].extent( 0 );
 
-        break;
-    }
-    default:
-        throw DataTransferKitNotImplementedException();
+        if ( n_ref_points != 0 )
+        {
+            Kokkos::View<Scalar **, DeviceType> basis_values =
+                getBasisValues( Scalar() )[topo_id];
+            Kokkos::View<LocalOrdinal **, DeviceType> dofs_ids =
+                _dofs_ids[topo_id];
+            unsigned int const n_basis = dofs_ids.extent( 1 );
+            Kokkos::parallel_for(
+                DTK_MARK_REGION( "interpolate_transpose" ),
+                Kokkos::RangePolicy<ExecutionSpace>( 0, n_ref_points ),
+                KOKKOS_LAMBDA( int const i ) {
+                    unsigned int const r = transpose_positions( offset + i );
+                    for ( unsigned int j = 0; j < n_basis; ++j )
+                        for ( unsigned int k = 0; k < n_fields; ++k )
+                            Kokkos::atomic_add(
+                                &X( dofs_ids( i, j ), k ),
+                                static_cast<Scalar>( basis_values( i, j ) *
+                                                     imported_Y( r, k ) ) );
+                } );
+            Kokkos::fence();
+            offset += n_ref_points;
+        }
     }
-    Kokkos::fence();
 }
+
 } // namespace DataTransferKit
 
 #endif
@@ -22,7 +22,21 @@ Interpolation<DeviceType>::Interpolation(
     MPI_Comm comm, Mesh<DeviceType> const &mesh,
     Kokkos::View<double **, DeviceType> points_coordinates,
     Kokkos::View<LocalOrdinal *, DeviceType> cell_dof_ids, DTK_FEType fe_type )
-    : _point_search( comm, mesh, points_coordinates )
+    : Interpolation( MeshSearchIndex<DeviceType>( comm, mesh ),
+                     points_coordinates, cell_dof_ids, fe_type )
+{
+}
+
+template <typename DeviceType>
+Interpolation<DeviceType>::Interpolation(
+    MeshSearchIndex<DeviceType> const &mesh_index,
+    Kokkos::View<double **, DeviceType> points_coordinates,
+    Kokkos::View<LocalOrdinal *, DeviceType> cell_dof_ids, DTK_FEType fe_type )
+    : _point_search( mesh_index, points_coordinates )
+    , _cell_dof_ids( cell_dof_ids )
+    , _fe_type( fe_type )
+    , _distributor( mesh_index.getComm() )
+    , _transpose_distributor( mesh_index.getComm() )
 {
     // Fill up _finite_element, i.e., fill up a map between topo_id and FE
     Topologies topologies;
@@ -30,7 +44,172 @@ Interpolation<DeviceType>::Interpolation(
         _finite_elements[topo_id] = getFE( topologies[topo_id].topo, fe_type );
 
     // Change the format of cell_dofs_ids
-    filter_dofs_ids( mesh.cell_topologies, cell_dof_ids, fe_type );
+    filter_dofs_ids( mesh_index._cell_topologies, cell_dof_ids, fe_type );
+
+    // The reference points are known, evaluate the basis functions
+    computeBasisValues();
+
+    // The query ids are known, compute where the values of each point are
+    buildQueryIdsBuffers();
+}
+
+template <typename DeviceType>
+void Interpolation<DeviceType>::update(
+    Kokkos::View<double **, DeviceType> points_coordinates )
+{
+    _point_search.update( points_coordinates );
+
+    // The cells where the points are found have changed
+    filter_dofs_ids( _point_search._mesh_index._cell_topologies, _cell_dof_ids,
+                     _fe_type );
+    computeBasisValues();
+    buildQueryIdsBuffers();
+
+    // The single precision basis values and the gradients of the basis
+    // functions will be recomputed if they are needed
+    _have_basis_values_float = false;
+    _have_basis_gradients = false;
+}
+
+template <typename DeviceType>
+void Interpolation<DeviceType>::buildQueryIdsBuffers()
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    // Flatten the query ids and the ranks of the processors owning the
+    // points in the order used to send the values
+    unsigned int n_local_ref_pts = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+        n_local_ref_pts += _point_search._query_ids[topo_id].extent( 0 );
+    Kokkos::View<unsigned int *, DeviceType> query_ids( "query_ids",
+                                                        n_local_ref_pts );
+    Kokkos::View<int *, DeviceType> ranks( "ranks", n_local_ref_pts );
+    unsigned int n_copied_pts = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+    {
+        unsigned int const size = _point_search._query_ids[topo_id].extent( 0 );
+        auto topo_query_ids = _point_search._query_ids[topo_id];
+        auto topo_ranks = _point_search._ranks[topo_id];
+        Kokkos::parallel_for( DTK_MARK_REGION( "query_ids" ),
+                              Kokkos::RangePolicy<ExecutionSpace>( 0, size ),
+                              KOKKOS_LAMBDA( int const i ) {
+                                  query_ids( i + n_copied_pts ) =
+                                      topo_query_ids( i );
+                                  ranks( i + n_copied_pts ) = topo_ranks( i );
+                              } );
+        Kokkos::fence();
+
+        n_copied_pts += size;
+    }
+    unsigned int const n_imports = _distributor.createFromSends( ranks );
+    Kokkos::View<unsigned int *, DeviceType> imported_query_ids(
+        "imported_query_ids", n_imports );
+    _distributor.doPostsAndWaits( query_ids, imported_query_ids );
+
+    // applyTranspose() needs to know where each value came from
+    int comm_rank;
+    MPI_Comm_rank( _point_search._comm, &comm_rank );
+    Kokkos::View<int *, DeviceType> cell_ranks( "cell_ranks",
+                                                n_local_ref_pts );
+    Kokkos::deep_copy( cell_ranks, comm_rank );
+    Kokkos::View<int *, DeviceType> indices( "indices", n_local_ref_pts );
+    ArborX::iota( indices );
+    _imported_cell_ranks =
+        Kokkos::View<int *, DeviceType>( "imported_cell_ranks", n_imports );
+    _imported_indices =
+        Kokkos::View<int *, DeviceType>( "imported_indices", n_imports );
+    _distributor.doPostsAndWaits( cell_ranks, _imported_cell_ranks );
+    _distributor.doPostsAndWaits( indices, _imported_indices );
+    _have_transpose_distributor = false;
+
+    // Because of the MPI communications and the sorting by topologies, all
+    // the queries have been reordered. The query ids are dense so we find,
+    // for each query, the value received. If a query was received more than
+    // once, the first value is used.
+    unsigned int const n_points = _point_search._n_points;
+    Kokkos::View<unsigned int *, DeviceType> first_import( "first_import",
+                                                           n_points );
+    Kokkos::deep_copy( first_import, n_imports );
+    Kokkos::parallel_for( DTK_MARK_REGION( "find_first_import" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              Kokkos::atomic_fetch_min(
+                                  &first_import( imported_query_ids( i ) ),
+                                  static_cast<unsigned int>( i ) );
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<int *, DeviceType> found_query_ids( "found_query_ids",
+                                                     n_points );
+    Kokkos::deep_copy( found_query_ids, -1 );
+    Kokkos::View<unsigned int *, DeviceType> found_imports( "found_imports",
+                                                            n_points );
+    unsigned int n_found = 0;
+    Kokkos::parallel_scan(
+        DTK_MARK_REGION( "compact_found_queries" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+        KOKKOS_LAMBDA( int const q, unsigned int &k, bool const final_pass ) {
+            unsigned int const i = first_import( q );
+            if ( i != n_imports )
+            {
+                if ( final_pass )
+                {
+                    found_imports( k ) = i;
+                    found_query_ids( k ) = q;
+                }
+                ++k;
+            }
+        },
+        n_found );
+    Kokkos::fence();
+
+    _found_imports =
+        Kokkos::subview( found_imports, Kokkos::make_pair( 0u, n_found ) );
+    _found_query_ids = found_query_ids;
+}
+
+template <typename DeviceType>
+void Interpolation<DeviceType>::computeSinglePrecisionBasisValues()
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+    {
+        Kokkos::View<Coordinate **, DeviceType> basis_values =
+            _basis_values[topo_id];
+        unsigned int const n_ref_points = basis_values.extent( 0 );
+        unsigned int const n_basis = basis_values.extent( 1 );
+        Kokkos::View<float **, DeviceType> basis_values_float(
+            "basis_values_float", n_ref_points, n_basis );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "convert_basis_values" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_ref_points ),
+            KOKKOS_LAMBDA( int const i ) {
+                for ( unsigned int j = 0; j < n_basis; ++j )
+                    basis_values_float( i, j ) =
+                        static_cast<float>( basis_values( i, j ) );
+            } );
+        Kokkos::fence();
+        _basis_values_float[topo_id] = basis_values_float;
+    }
+    _have_basis_values_float = true;
+}
+
+template <typename DeviceType>
+std::array<Kokkos::View<Coordinate **, DeviceType>, DTK_N_TOPO> const &
+    Interpolation<DeviceType>::getBasisValues( double )
+{
+    return _basis_values;
+}
+
+template <typename DeviceType>
+std::array<Kokkos::View<float **, DeviceType>, DTK_N_TOPO> const &
+    Interpolation<DeviceType>::getBasisValues( float )
+{
+    if ( !_have_basis_values_float )
+        computeSinglePrecisionBasisValues();
+
+    return _basis_values_float;
 }
 
 template <typename DeviceType>
@@ -38,70 +217,406 @@ void Interpolation<DeviceType>::filter_dofs_ids(
     Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies,
     Kokkos::View<LocalOrdinal *, DeviceType> cell_dof_ids, DTK_FEType fe_type )
 {
-    // We need to filter the dof_ids and only keep the cells where a point
-    // was found. Because multiple points may be in the same cells, the
-    // cells may be duplicated.
-    // TODO do this on the device
-    auto cell_topologies_host = Kokkos::create_mirror_view( cell_topologies );
-    Kokkos::deep_copy( cell_topologies_host, cell_topologies );
+    using ExecutionSpace = typename DeviceType::execution_space;
 
-    unsigned int const n_cells = cell_topologies.extent( 0 );
     // We need to compute the number of basis function for each cell because the
     // number of basis functions is different for HGRAD, HDIV, and HCURL.
     // Therefore, knowing the number of nodes in the topology is not enough.
-    std::vector<unsigned int> dof_offset( n_cells + 1 );
-    for ( unsigned int i = 0; i < n_cells; ++i )
+    // The number of basis functions only depends on the topology so we
+    // tabulate it once.
+    Kokkos::View<unsigned int[DTK_N_TOPO], DeviceType> topo_cardinality(
+        "topo_cardinality" );
+    auto topo_cardinality_host = Kokkos::create_mirror_view( topo_cardinality );
+    for ( unsigned int topo = 0; topo < DTK_N_TOPO; ++topo )
+        topo_cardinality_host( topo ) = getCardinality(
+            getFE( static_cast<DTK_CellTopology>( topo ), fe_type ) );
+    Kokkos::deep_copy( topo_cardinality, topo_cardinality_host );
+
+    unsigned int const n_cells = cell_topologies.extent( 0 );
+    Kokkos::View<unsigned int *, DeviceType> dof_offset( "dof_offset",
+                                                         n_cells + 1 );
+    Kokkos::parallel_for( DTK_MARK_REGION( "count_dofs_per_cell" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_cells ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              dof_offset( i ) =
+                                  topo_cardinality( cell_topologies( i ) );
+                          } );
+    Kokkos::fence();
+    ArborX::exclusivePrefixSum( dof_offset );
+
+    // We need to filter the dof_ids and only keep the cells where a point
+    // was found. Because multiple points may be in the same cells, the
+    // cells may be duplicated.
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
     {
-        auto fe = getFE( cell_topologies_host( i ), fe_type );
-        dof_offset[i + 1] = dof_offset[i] + getCardinality<DeviceType>( fe );
+        unsigned int const fe_n_cells =
+            _point_search._query_ids[topo_id].extent( 0 );
+        unsigned int const n_dofs_per_cell =
+            ( fe_n_cells > 0 ) ? getCardinality( _finite_elements[topo_id] )
+                               : 0;
+        Kokkos::View<LocalOrdinal **, DeviceType> dofs_ids(
+            "cell_dofs_ids_" + std::to_string( topo_id ), fe_n_cells,
+            n_dofs_per_cell );
+        _dofs_ids[topo_id] = dofs_ids;
+        if ( fe_n_cells == 0 )
+            continue;
+
+        // We cannot use private member in a lambda function with CUDA
+        Kokkos::View<unsigned int *, DeviceType> cell_indices_map =
+            _point_search._mesh_index._cell_indices_map[topo_id];
+        Kokkos::View<int *, DeviceType> cell_indices =
+            _point_search._cell_indices[topo_id];
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "gather_dofs_ids" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, fe_n_cells ),
+            KOKKOS_LAMBDA( int const i ) {
+                unsigned int const offset =
+                    dof_offset( cell_indices_map( cell_indices( i ) ) );
+                for ( unsigned int j = 0; j < n_dofs_per_cell; ++j )
+                    dofs_ids( i, j ) = cell_dof_ids( offset + j );
+            } );
+        Kokkos::fence();
     }
+}
 
-    auto cell_dof_ids_host = Kokkos::create_mirror_view( cell_dof_ids );
-    Kokkos::deep_copy( cell_dof_ids_host, cell_dof_ids );
-    std::array<std::vector<std::vector<unsigned int>>, DTK_N_TOPO>
-        filtered_dof_ids;
-    // For each topo_id (finite element type) we reformat cell_dof_ids
+template <typename DeviceType>
+void Interpolation<DeviceType>::computeBasisValues()
+{
     for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
     {
-        unsigned int const n_dofs_per_cell =
-            getCardinality<DeviceType>( _finite_elements[topo_id] );
-
-        // For each cell which contains a target point, we reformat cell_dof_ids
-        for ( unsigned int i = 0;
-              i < _point_search._query_ids[topo_id].extent( 0 ); ++i )
-        {
-            unsigned int const cell_id =
-                _point_search._cell_indices_map
-                    [topo_id][_point_search._cell_indices[topo_id]( i )];
-            unsigned int const offset = dof_offset[cell_id];
-            std::vector<unsigned int> current_cell_dof_ids( n_dofs_per_cell );
-            for ( unsigned int j = 0; j < n_dofs_per_cell; ++j )
-                current_cell_dof_ids[j] = cell_dof_ids_host( offset + j );
-            filtered_dof_ids[topo_id].push_back( current_cell_dof_ids );
-        }
-    }
-
-    // Copy in a Kokkos::View and then move it to the device
+        unsigned int const n_ref_points =
+            _point_search._reference_points[topo_id].extent( 0 );
+        unsigned int const n_basis =
+            ( n_ref_points != 0 )
+                ? getCardinality( _finite_elements[topo_id] )
+                : 0;
+        _basis_values[topo_id] = Kokkos::View<Coordinate **, DeviceType>(
+            "basis_values_" + std::to_string( topo_id ), n_ref_points,
+            n_basis );
+        if ( n_ref_points != 0 )
+            basisValuesDispatch( _finite_elements[topo_id], topo_id );
+    }
+}
+
+template <typename DeviceType>
+template <typename FEOpType>
+void Interpolation<DeviceType>::vectorBasisValues(
+    Kokkos::View<Coordinate **, DeviceType> ref_points,
+    Kokkos::View<Coordinate **, DeviceType> basis_values )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    Functor::BasisValues<FEOpType, DeviceType> basis_values_functor(
+        _point_search._dim, ref_points, basis_values );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "compute_basis_values" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, ref_points.extent( 0 ) ),
+        basis_values_functor );
+}
+
+template <typename DeviceType>
+template <typename FEOpType>
+void Interpolation<DeviceType>::hgradBasisValues(
+    Kokkos::View<Coordinate **, DeviceType> ref_points,
+    Kokkos::View<Coordinate **, DeviceType> basis_values )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    Functor::HgradBasisValues<FEOpType, DeviceType> basis_values_functor(
+        ref_points, basis_values );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "compute_basis_values" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, ref_points.extent( 0 ) ),
+        basis_values_functor );
+}
+
+template <typename DeviceType>
+void Interpolation<DeviceType>::basisValuesDispatch( FE fe,
+                                                     unsigned int topo_id )
+{
+    switch ( fe )
+    {
+    case FE::HEX_HCURL_1:
+    {
+        vectorBasisValues<HEX_HCURL_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::HEX_HDIV_1:
+    {
+        vectorBasisValues<HEX_HDIV_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::HEX_HGRAD_1:
+    {
+        hgradBasisValues<HEX_HGRAD_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::HEX_HGRAD_2:
+    {
+        hgradBasisValues<HEX_HGRAD_2::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::PYR_HGRAD_1:
+    {
+        hgradBasisValues<PYR_HGRAD_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::QUAD_HCURL_1:
+    {
+        vectorBasisValues<QUAD_HCURL_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::QUAD_HDIV_1:
+    {
+        vectorBasisValues<QUAD_HDIV_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::QUAD_HGRAD_1:
+    {
+        hgradBasisValues<QUAD_HGRAD_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::QUAD_HGRAD_2:
+    {
+        hgradBasisValues<QUAD_HGRAD_2::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::TET_HCURL_1:
+    {
+        vectorBasisValues<TET_HCURL_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::TET_HDIV_1:
+    {
+        vectorBasisValues<TET_HDIV_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::TET_HGRAD_1:
+    {
+        hgradBasisValues<TET_HGRAD_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::TET_HGRAD_2:
+    {
+        hgradBasisValues<TET_HGRAD_2::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::TRI_HGRAD_1:
+    {
+        hgradBasisValues<TRI_HGRAD_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::TRI_HGRAD_2:
+    {
+        hgradBasisValues<TRI_HGRAD_2::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::WEDGE_HGRAD_1:
+    {
+        hgradBasisValues<WEDGE_HGRAD_1::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    case FE::WEDGE_HGRAD_2:
+    {
+        hgradBasisValues<WEDGE_HGRAD_2::feop_type>(
+            _point_search._reference_points[topo_id], _basis_values[topo_id] );
+
+        break;
+    }
+    default:
+        throw DataTransferKitNotImplementedException();
+    }
+    Kokkos::fence();
+}
+
+template <typename DeviceType>
+void Interpolation<DeviceType>::buildTransposeDistributor()
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    // Send the values back to the processors owning the cells
+    auto imported_cell_ranks_host =
+        Kokkos::create_mirror_view( _imported_cell_ranks );
+    Kokkos::deep_copy( imported_cell_ranks_host, _imported_cell_ranks );
+    unsigned int const n_results =
+        _transpose_distributor.createFromSends( imported_cell_ranks_host );
+
+    // The values are not received in the order of the results. Find, for
+    // each result, the position of its value in the received values.
+    Kokkos::View<int *, DeviceType> result_indices( "result_indices",
+                                                    n_results );
+    ArborX::Details::DistributedSearchTreeImpl<DeviceType>::sendAcrossNetwork(
+        _transpose_distributor, _imported_indices, result_indices );
+    Kokkos::View<unsigned int *, DeviceType> transpose_positions(
+        "transpose_positions", n_results );
+    Kokkos::parallel_for( DTK_MARK_REGION( "compute_transpose_positions" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_results ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              transpose_positions( result_indices( i ) ) = i;
+                          } );
+    Kokkos::fence();
+    _transpose_positions = transpose_positions;
+    _have_transpose_distributor = true;
+}
+
+template <typename DeviceType>
+void Interpolation<DeviceType>::computeBasisGradients()
+{
+    Topologies topologies;
     for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
     {
-        unsigned int const fe_n_cells = filtered_dof_ids[topo_id].size();
-        unsigned int const n_dofs_per_cell =
-            ( fe_n_cells > 0 ) ? filtered_dof_ids[topo_id][0].size() : 0;
-        _dofs_ids[topo_id] = Kokkos::View<LocalOrdinal **, DeviceType>(
-            "cell_dofs_ids_" + std::to_string( topo_id ), fe_n_cells,
-            n_dofs_per_cell );
-        auto dofs_ids_host = Kokkos::create_mirror_view( _dofs_ids[topo_id] );
-        for ( unsigned int i = 0; i < fe_n_cells; ++i )
-            for ( unsigned int j = 0; j < n_dofs_per_cell; ++j )
-                dofs_ids_host( i, j ) = filtered_dof_ids[topo_id][i][j];
-        Kokkos::deep_copy( _dofs_ids[topo_id], dofs_ids_host );
+        unsigned int const n_ref_points =
+            _point_search._reference_points[topo_id].extent( 0 );
+        unsigned int const n_basis =
+            ( n_ref_points != 0 ) ? getCardinality( _finite_elements[topo_id] )
+                                  : 0;
+        _basis_gradients[topo_id] = Kokkos::View<Coordinate ***, DeviceType>(
+            "basis_gradients_" + std::to_string( topo_id ), n_ref_points,
+            n_basis, _point_search._dim );
+        if ( n_ref_points != 0 )
+            basisGradientsDispatch( topologies[topo_id].topo, topo_id );
     }
+    _have_basis_gradients = true;
+}
+
+template <typename DeviceType>
+template <typename CellType>
+void Interpolation<DeviceType>::hgradBasisGradients( unsigned int topo_id )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    Functor::HgradBasisGradients<CellType, DeviceType> basis_gradients_functor(
+        _point_search._reference_points[topo_id],
+        _point_search._mesh_index._block_cells[topo_id],
+        _point_search._cell_indices[topo_id], _basis_gradients[topo_id] );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "compute_basis_gradients" ),
+        Kokkos::RangePolicy<ExecutionSpace>(
+            0, _basis_gradients[topo_id].extent( 0 ) ),
+        basis_gradients_functor );
 }
 
+template <typename DeviceType>
+void Interpolation<DeviceType>::basisGradientsDispatch( DTK_CellTopology topo,
+                                                        unsigned int topo_id )
+{
+    switch ( topo )
+    {
+    case DTK_HEX_8:
+    {
+        hgradBasisGradients<HEX_8>( topo_id );
+        break;
+    }
+    case DTK_HEX_27:
+    {
+        hgradBasisGradients<HEX_27>( topo_id );
+        break;
+    }
+    case DTK_PYRAMID_5:
+    {
+        hgradBasisGradients<PYRAMID_5>( topo_id );
+        break;
+    }
+    case DTK_QUAD_4:
+    {
+        hgradBasisGradients<QUAD_4>( topo_id );
+        break;
+    }
+    case DTK_QUAD_9:
+    {
+        hgradBasisGradients<QUAD_9>( topo_id );
+        break;
+    }
+    case DTK_TET_4:
+    {
+        hgradBasisGradients<TET_4>( topo_id );
+        break;
+    }
+    case DTK_TET_10:
+    {
+        hgradBasisGradients<TET_10>( topo_id );
+        break;
+    }
+    case DTK_TRI_3:
+    {
+        hgradBasisGradients<TRI_3>( topo_id );
+        break;
+    }
+    case DTK_TRI_6:
+    {
+        hgradBasisGradients<TRI_6>( topo_id );
+        break;
+    }
+    case DTK_WEDGE_6:
+    {
+        hgradBasisGradients<WEDGE_6>( topo_id );
+        break;
+    }
+    case DTK_WEDGE_18:
+    {
+        hgradBasisGradients<WEDGE_18>( topo_id );
+        break;
+    }
+    default:
+        throw DataTransferKitNotImplementedException();
+    }
+    Kokkos::fence();
+}
 } // namespace DataTransferKit
 
 // Explicit instantiation macro
+#define DTK_INTERPOLATION_SCALAR_INSTANT( SCALAR, NODE )                       \
+    template Kokkos::View<int *, typename NODE::device_type>                   \
+    Interpolation<typename NODE::device_type>::apply(                          \
+        Kokkos::View<SCALAR **, typename NODE::device_type>,                   \
+        Kokkos::View<SCALAR **, typename NODE::device_type> );                 \
+    template void Interpolation<typename NODE::device_type>::applyBegin(       \
+        Kokkos::View<SCALAR **, typename NODE::device_type>,                   \
+        Kokkos::View<SCALAR **, typename NODE::device_type> );                 \
+    template Kokkos::View<int *, typename NODE::device_type>                   \
+    Interpolation<typename NODE::device_type>::applyEnd(                       \
+        Kokkos::View<SCALAR **, typename NODE::device_type> );                 \
+    template Kokkos::View<int *, typename NODE::device_type>                   \
+    Interpolation<typename NODE::device_type>::apply(                          \
+        Kokkos::View<SCALAR **, typename NODE::device_type>,                   \
+        Kokkos::View<SCALAR **, typename NODE::device_type>,                   \
+        Kokkos::View<SCALAR ***, typename NODE::device_type> );                \
+    template void Interpolation<typename NODE::device_type>::applyTranspose(   \
+        Kokkos::View<SCALAR **, typename NODE::device_type>,                   \
+        Kokkos::View<SCALAR **, typename NODE::device_type> );
+
 #define DTK_INTERPOLATION_INSTANT( NODE )                                      \
-    template class Interpolation<typename NODE::device_type>;
+    template class Interpolation<typename NODE::device_type>;                  \
+    DTK_INTERPOLATION_SCALAR_INSTANT( double, NODE )                           \
+    DTK_INTERPOLATION_SCALAR_INSTANT( float, NODE )
 
 #endif
@@ -0,0 +1,83 @@
+/****************************************************************************
+ * Copyright (c) 2012-2019 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_MESH_SEARCH_INDEX_DECL_HPP
+#define DTK_MESH_SEARCH_INDEX_DECL_HPP
+
+#include "DTK_ConfigDefs.hpp"
+#include <ArborX.hpp>
+#include <DTK_CellTypes.h>
+#include <DTK_Mesh.hpp>
+
+#include <Kokkos_View.hpp>
+
+#include <mpi.h>
+
+#include <array>
+
+namespace DataTransferKit
+{
+/**
+ * This class owns the preprocessed representation of a mesh that is needed to
+ * search points in it: the cells sorted by topology, their bounding boxes, and
+ * the distributed search tree built on top of the bounding boxes. Building the
+ * index is collective and is the most expensive part of the search. When the
+ * same mesh is searched repeatedly with different points, the index should be
+ * built once and passed to PointSearch or Interpolation. Copies of the index
+ * are shallow.
+ */
+template <typename DeviceType>
+class MeshSearchIndex
+{
+  public:
+    /**
+     * Constructor.
+     * @param comm
+     * @param mesh mesh of the domain of interest
+     */
+    MeshSearchIndex( MPI_Comm comm, Mesh<DeviceType> const &mesh );
+
+    /**
+     * Return the communicator used to build the distributed search tree.
+     */
+    MPI_Comm getComm() const { return _comm; }
+
+    /**
+     * Return the dimension of the mesh.
+     */
+    unsigned int getDimension() const { return _dim; }
+
+  private:
+    /**
+     * Convert the mesh into block cells and compute the bounding boxes of the
+     * cells.
+     */
+    Kokkos::View<ArborX::Box *, DeviceType>
+    buildBoundingBoxes( Mesh<DeviceType> const &mesh );
+
+    template <typename T>
+    friend class PointSearch;
+
+    template <typename T>
+    friend class Interpolation;
+
+    MPI_Comm _comm;
+    unsigned int _dim;
+    Kokkos::View<DTK_CellTopology *, DeviceType> _cell_topologies;
+    std::array<Kokkos::View<double ***, DeviceType>, DTK_N_TOPO> _block_cells;
+    Kokkos::View<unsigned int **, DeviceType> _bounding_box_to_cell;
+    ArborX::DistributedSearchTree<DeviceType> _distributed_tree;
+    std::array<Kokkos::View<unsigned int *, DeviceType>, DTK_N_TOPO>
+        _cell_indices_map;
+};
+} // namespace DataTransferKit
+
+#endif
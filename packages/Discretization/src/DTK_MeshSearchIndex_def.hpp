@@ -0,0 +1,99 @@
+/****************************************************************************
+ * Copyright (c) 2012-2019 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_MESH_SEARCH_INDEX_DEF_HPP
+#define DTK_MESH_SEARCH_INDEX_DEF_HPP
+
+#include <ArborX.hpp>
+#include <DTK_DBC.hpp>
+#include <DTK_DiscretizationHelpers.hpp>
+
+namespace DataTransferKit
+{
+template <typename DeviceType>
+MeshSearchIndex<DeviceType>::MeshSearchIndex( MPI_Comm comm,
+                                              Mesh<DeviceType> const &mesh )
+    : _comm( comm )
+    , _dim( mesh.nodes_coordinates.extent( 1 ) )
+    , _cell_topologies( mesh.cell_topologies )
+    , _distributed_tree( _comm, buildBoundingBoxes( mesh ) )
+{
+    // Build a map between the cell_indices sorted by topology and the flat View
+    // given to the constructor by inverting _bounding_box_to_cell.
+    using ExecutionSpace = typename DeviceType::execution_space;
+    unsigned int const n_cells = mesh.cell_topologies.extent( 0 );
+    auto bounding_box_to_cell = _bounding_box_to_cell;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+    {
+        _cell_indices_map[topo_id] = Kokkos::View<unsigned int *, DeviceType>(
+            "cell_indices_map_" + std::to_string( topo_id ),
+            _block_cells[topo_id].extent( 0 ) );
+        if ( _block_cells[topo_id].extent( 0 ) == 0 )
+            continue;
+
+        auto cell_indices_map = _cell_indices_map[topo_id];
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "build_cell_indices_map" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_cells ),
+            KOKKOS_LAMBDA( int const i ) {
+                unsigned int const j = bounding_box_to_cell( i, topo_id );
+                if ( j != static_cast<unsigned int>( -1 ) )
+                    cell_indices_map( j ) = i;
+            } );
+        Kokkos::fence();
+    }
+}
+
+template <typename DeviceType>
+Kokkos::View<ArborX::Box *, DeviceType>
+MeshSearchIndex<DeviceType>::buildBoundingBoxes( Mesh<DeviceType> const &mesh )
+{
+    // Compute the number of cells of each of the supported topologies.
+    std::array<unsigned int, DTK_N_TOPO> n_cells_per_topo =
+        Discretization::Helpers::computeNCellsPerTopology(
+            mesh.cell_topologies );
+
+    // Compute the topology and node offset
+    Discretization::Helpers::MeshOffsets<DeviceType> mesh_offsets( mesh );
+
+    // Convert the cells and cell_nodes_coordinates View to block_cells
+    auto n_nodes_per_topo_host =
+        Kokkos::create_mirror_view( mesh_offsets.n_nodes_per_topo );
+    Kokkos::deep_copy( n_nodes_per_topo_host, mesh_offsets.n_nodes_per_topo );
+    for ( int i = 0; i < DTK_N_TOPO; ++i )
+    {
+        _block_cells[i] = Kokkos::View<double ***, DeviceType>(
+            "block_cells_" + std::to_string( i ), n_cells_per_topo[i],
+            n_nodes_per_topo_host( i ), _dim );
+    }
+    Discretization::Helpers::convertMesh( mesh, mesh_offsets, _block_cells );
+
+    // Initialize bounding_box_to_cell to an invalid state
+    _bounding_box_to_cell = Kokkos::View<unsigned int **, DeviceType>(
+        "bounding_box_to_cell", mesh.cell_topologies.extent( 0 ), DTK_N_TOPO );
+    Kokkos::deep_copy( _bounding_box_to_cell,
+                       static_cast<unsigned int>( -1 ) );
+
+    Kokkos::View<ArborX::Box *, DeviceType> bounding_boxes(
+        "bounding_boxes", mesh.cell_topologies.extent( 0 ) );
+    Discretization::Helpers::createBoundingBoxes( mesh, mesh_offsets,
+                                                  _block_cells, bounding_boxes,
+                                                  _bounding_box_to_cell );
+
+    return bounding_boxes;
+}
+} // namespace DataTransferKit
+
+// Explicit instantiation macro
+#define DTK_MESHSEARCHINDEX_INSTANT( NODE )                                    \
+    template class MeshSearchIndex<typename NODE::device_type>;
+
+#endif
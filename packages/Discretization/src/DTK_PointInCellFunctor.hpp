@@ -12,14 +12,223 @@
 #ifndef DTK_POINT_IN_CELL_FUNCTOR_HPP
 #define DTK_POINT_IN_CELL_FUNCTOR_HPP
 
+#include <DTK_Topology.hpp>
+
 #include <Intrepid2_CellTools_Serial.hpp>
 #include <Kokkos_Macros.hpp>
 #include <Kokkos_View.hpp>
 
+#include <cmath>
+
 namespace DataTransferKit
 {
 namespace Functor
 {
+namespace Details
+{
+/**
+ * Return the determinant of the 3x3 matrix whose columns are \p a, \p b,
+ * and \p c.
+ */
+KOKKOS_INLINE_FUNCTION double tripleProduct( double const *a, double const *b,
+                                             double const *c )
+{
+    return a[0] * ( b[1] * c[2] - b[2] * c[1] ) -
+           a[1] * ( b[0] * c[2] - b[2] * c[0] ) +
+           a[2] * ( b[0] * c[1] - b[1] * c[0] );
+}
+
+/**
+ * Compute the reference coordinates of a point for a map x = origin + J ref,
+ * where jacobian[j] is the j-th column of J. Return false if J is singular.
+ */
+template <typename RefPointType, typename PhysPointType>
+KOKKOS_INLINE_FUNCTION bool
+solveAffineMap( double const ( &origin )[2], double const ( &jacobian )[2][2],
+                RefPointType &ref_point, PhysPointType const &phys_point )
+{
+    double const rhs[2] = {phys_point( 0 ) - origin[0],
+                           phys_point( 1 ) - origin[1]};
+    double const det =
+        jacobian[0][0] * jacobian[1][1] - jacobian[1][0] * jacobian[0][1];
+    if ( det == 0. )
+        return false;
+    ref_point( 0 ) =
+        ( rhs[0] * jacobian[1][1] - rhs[1] * jacobian[1][0] ) / det;
+    ref_point( 1 ) =
+        ( jacobian[0][0] * rhs[1] - jacobian[0][1] * rhs[0] ) / det;
+
+    return true;
+}
+
+template <typename RefPointType, typename PhysPointType>
+KOKKOS_INLINE_FUNCTION bool
+solveAffineMap( double const ( &origin )[3], double const ( &jacobian )[3][3],
+                RefPointType &ref_point, PhysPointType const &phys_point )
+{
+    double const rhs[3] = {phys_point( 0 ) - origin[0],
+                           phys_point( 1 ) - origin[1],
+                           phys_point( 2 ) - origin[2]};
+    // Cramer's rule: ref(j) = det(J with column j replaced by rhs) / det(J)
+    double const det = tripleProduct( jacobian[0], jacobian[1], jacobian[2] );
+    if ( det == 0. )
+        return false;
+    ref_point( 0 ) = tripleProduct( rhs, jacobian[1], jacobian[2] ) / det;
+    ref_point( 1 ) = tripleProduct( jacobian[0], rhs, jacobian[2] ) / det;
+    ref_point( 2 ) = tripleProduct( jacobian[0], jacobian[1], rhs ) / det;
+
+    return true;
+}
+
+/**
+ * Return true if \p value is equal to \p expected up to a tolerance relative
+ * to the size \p h of the cell.
+ */
+KOKKOS_INLINE_FUNCTION bool isClose( double const value, double const expected,
+                                     double const h )
+{
+    return std::abs( value - expected ) <= 1e-12 * h;
+}
+
+/**
+ * Closed-form inverse of the map to the reference frame for the cells whose
+ * map is affine. The default implementation never applies and the Newton
+ * solver of Intrepid2 is used instead.
+ */
+template <typename CellType>
+struct AffineMap
+{
+    template <typename RefPointType, typename PhysPointType,
+              typename NodesType>
+    KOKKOS_INLINE_FUNCTION static bool
+    mapToReferenceFrame( RefPointType &, PhysPointType const &,
+                         NodesType const & )
+    {
+        return false;
+    }
+};
+
+/**
+ * Simplices: the map is always affine. The reference vertices are the origin
+ * and the unit vectors.
+ */
+template <int dim>
+struct SimplexAffineMap
+{
+    template <typename RefPointType, typename PhysPointType,
+              typename NodesType>
+    KOKKOS_INLINE_FUNCTION static bool
+    mapToReferenceFrame( RefPointType &ref_point,
+                         PhysPointType const &phys_point,
+                         NodesType const &nodes )
+    {
+        double origin[dim];
+        double jacobian[dim][dim];
+        for ( int d = 0; d < dim; ++d )
+            origin[d] = nodes( 0, d );
+        for ( int j = 0; j < dim; ++j )
+            for ( int d = 0; d < dim; ++d )
+                jacobian[j][d] = nodes( j + 1, d ) - nodes( 0, d );
+
+        return solveAffineMap( origin, jacobian, ref_point, phys_point );
+    }
+};
+
+template <>
+struct AffineMap<TRI_3> : SimplexAffineMap<2>
+{
+};
+
+template <>
+struct AffineMap<TET_4> : SimplexAffineMap<3>
+{
+};
+
+/**
+ * Parallelograms: the map is affine if the opposite edges are parallel, i.e.,
+ * if node 2 is equal to node 1 + node 3 - node 0. The reference cell is
+ * [-1,1]^2.
+ */
+template <>
+struct AffineMap<QUAD_4>
+{
+    template <typename RefPointType, typename PhysPointType,
+              typename NodesType>
+    KOKKOS_INLINE_FUNCTION static bool
+    mapToReferenceFrame( RefPointType &ref_point,
+                         PhysPointType const &phys_point,
+                         NodesType const &nodes )
+    {
+        int constexpr dim = 2;
+        double jacobian[dim][dim];
+        double h = 0.;
+        for ( int d = 0; d < dim; ++d )
+        {
+            jacobian[0][d] = 0.5 * ( nodes( 1, d ) - nodes( 0, d ) );
+            jacobian[1][d] = 0.5 * ( nodes( 3, d ) - nodes( 0, d ) );
+            h += std::abs( jacobian[0][d] ) +
+                 std::abs( jacobian[1][d] );
+        }
+        double origin[dim];
+        for ( int d = 0; d < dim; ++d )
+        {
+            if ( !isClose( nodes( 2, d ),
+                           nodes( 1, d ) + nodes( 3, d ) - nodes( 0, d ), h ) )
+                return false;
+            origin[d] = nodes( 0, d ) + jacobian[0][d] + jacobian[1][d];
+        }
+
+        return solveAffineMap( origin, jacobian, ref_point, phys_point );
+    }
+};
+
+/**
+ * Parallelepipeds: the map is affine if all the faces are parallelograms,
+ * i.e., if every node is the sum of node 0 and of the edges going from node
+ * 0 to nodes 1, 3, and 4. The reference cell is [-1,1]^3.
+ */
+template <>
+struct AffineMap<HEX_8>
+{
+    template <typename RefPointType, typename PhysPointType,
+              typename NodesType>
+    KOKKOS_INLINE_FUNCTION static bool
+    mapToReferenceFrame( RefPointType &ref_point,
+                         PhysPointType const &phys_point,
+                         NodesType const &nodes )
+    {
+        int constexpr dim = 3;
+        double jacobian[dim][dim];
+        double h = 0.;
+        for ( int d = 0; d < dim; ++d )
+        {
+            jacobian[0][d] = 0.5 * ( nodes( 1, d ) - nodes( 0, d ) );
+            jacobian[1][d] = 0.5 * ( nodes( 3, d ) - nodes( 0, d ) );
+            jacobian[2][d] = 0.5 * ( nodes( 4, d ) - nodes( 0, d ) );
+            h += std::abs( jacobian[0][d] ) +
+                 std::abs( jacobian[1][d] ) +
+                 std::abs( jacobian[2][d] );
+        }
+        double origin[dim];
+        for ( int d = 0; d < dim; ++d )
+        {
+            double const x0 = nodes( 0, d );
+            double const e1 = nodes( 1, d ) - x0;
+            double const e3 = nodes( 3, d ) - x0;
+            double const e4 = nodes( 4, d ) - x0;
+            if ( !isClose( nodes( 2, d ), x0 + e1 + e3, h ) ||
+                 !isClose( nodes( 5, d ), x0 + e1 + e4, h ) ||
+                 !isClose( nodes( 6, d ), x0 + e1 + e3 + e4, h ) ||
+                 !isClose( nodes( 7, d ), x0 + e3 + e4, h ) )
+                return false;
+            origin[d] = x0 + jacobian[0][d] + jacobian[1][d] + jacobian[2][d];
+        }
+
+        return solveAffineMap( origin, jacobian, ref_point, phys_point );
+    }
+};
+} // namespace Details
+
 template <typename CellType, typename DeviceType>
 class PointInCell
 {
@@ -54,10 +263,13 @@ class PointInCell
         Kokkos::View<Coordinate **, Kokkos::LayoutStride, ExecutionSpace> nodes(
             _cells, cell_index, Kokkos::ALL(), Kokkos::ALL() );
 
-        // Compute the reference point and return true if the
-        // point is inside the cell
-        Intrepid2::Impl::CellTools::Serial::mapToReferenceFrame<
-            typename CellType::basis_type>( ref_point, phys_point, nodes );
+        // Compute the reference point and return true if the point is inside
+        // the cell. Affine cells are inverted directly, the other cells use
+        // the Newton solver of Intrepid2.
+        if ( !Details::AffineMap<CellType>::mapToReferenceFrame(
+                 ref_point, phys_point, nodes ) )
+            Intrepid2::Impl::CellTools::Serial::mapToReferenceFrame<
+                typename CellType::basis_type>( ref_point, phys_point, nodes );
         _point_in_cell[i] =
             CellType::topo_type::checkPointInclusion( ref_point, _threshold );
     }
@@ -16,6 +16,8 @@
 #include <ArborX.hpp>
 #include <DTK_CellTypes.h>
 #include <DTK_Mesh.hpp>
+#include <DTK_MeshSearchIndex.hpp>
+#include <DTK_PointOrdering.hpp>
 
 #include <Kokkos_View.hpp>
 
@@ -42,11 +44,37 @@ class PointSearch
      * @param mesh mesh of the domain of interest
      * @param points_coordinates coordinates in the physical frame of the points
      * that we are looking for.
+     * @param ordering order in which the points are searched for. The results
+     * are the same for all the orderings.
      * For a more detailed documentation on \p cell_topologies, \p
      * cells, and \p nodes_coordinates see the documentation of CellList.
      */
     PointSearch( MPI_Comm comm, Mesh<DeviceType> const &mesh,
-                 Kokkos::View<double **, DeviceType> points_coordinates );
+                 Kokkos::View<double **, DeviceType> points_coordinates,
+                 PointOrdering ordering = PointOrdering::Caller );
+
+    /**
+     * Constructor using a search index that has already been built for the
+     * mesh. The index is not modified and can be reused by other searches.
+     * @param mesh_index search index of the domain of interest
+     * @param points_coordinates coordinates in the physical frame of the points
+     * that we are looking for.
+     * @param ordering order in which the points are searched for.
+     */
+    PointSearch( MeshSearchIndex<DeviceType> const &mesh_index,
+                 Kokkos::View<double **, DeviceType> points_coordinates,
+                 PointOrdering ordering = PointOrdering::Caller );
+
+    /**
+     * Update the search after the points have moved. Each point is first
+     * checked against the cells where it was previously found. Only the
+     * points that left all of these cells go through the distributed search
+     * again. A point that is still in one of its previous cells is not
+     * searched for in the cells it may have entered.
+     * @param points_coordinates new coordinates in the physical frame of the
+     * points. The number of points and their order must not change.
+     */
+    void update( Kokkos::View<double **, DeviceType> points_coordinates );
 
     /**
      * Return the result of the search. The tuple contains the rank where the
@@ -69,13 +97,12 @@ class PointSearch
     std::tuple<Kokkos::View<ArborX::Point *, DeviceType>,
                Kokkos::View<int *, DeviceType>, Kokkos::View<int *, DeviceType>,
                Kokkos::View<int *, DeviceType>>
-    performDistributedSearch(
-        Kokkos::View<double **, DeviceType> points_coord,
-        Kokkos::View<ArborX::Box *, DeviceType> bounding_boxes );
+    performDistributedSearch( Kokkos::View<double **, DeviceType> points_coord,
+                              Kokkos::View<int *, DeviceType> query_ids );
 
     /**
-     * Keep cell_indices, points, query_ids, and ranks that satisfy a given
-     * topology.
+     * Gather cell_indices, points, query_ids, and ranks of the segment of the
+     * imports sorted by topology that corresponds to a given topology.
      *
      * @note This function should be <b>private</b> but lambda functions can
      * only be called from a public function in CUDA.
@@ -84,8 +111,8 @@ class PointSearch
                Kokkos::View<double **, DeviceType>,
                Kokkos::View<int *, DeviceType>, Kokkos::View<int *, DeviceType>>
     filterTopology(
-        Kokkos::View<unsigned int *, DeviceType> topo, unsigned int topo_id,
-        unsigned int size,
+        Kokkos::View<unsigned int *, DeviceType> permute, unsigned int offset,
+        unsigned int size, unsigned int topo_id,
         Kokkos::View<unsigned int **, DeviceType> bounding_box_to_cell,
         Kokkos::View<int *, DeviceType> cell_indices,
         Kokkos::View<ArborX::Point *, DeviceType> points,
@@ -106,13 +133,18 @@ class PointSearch
         Kokkos::View<int *, DeviceType> filtered_per_topo_ranks,
         unsigned int topo_id );
 
-  private:
     /**
-     * Compute the number of cells associated to each topology.
+     * Keep a single result for each point found in several cells, e.g., points
+     * on the faces, edges, or vertices shared by several cells. The result
+     * found on the processor with the lowest rank is kept. On this processor,
+     * the first result is kept.
+     *
+     * @note This function should be <b>private</b> but lambda functions can
+     * only be called from a public function in CUDA.
      */
-    std::array<unsigned int, DTK_N_TOPO> computeNCellsPerTopology(
-        Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies );
+    void removeDuplicates();
 
+  private:
     /**
      * Compute the position in the reference frame of candidates found by the
      * search.
@@ -124,26 +156,45 @@ class PointSearch
         Kokkos::View<ArborX::Point *, DeviceType> imported_points,
         Kokkos::View<int *, DeviceType> imported_query_ids,
         Kokkos::View<int *, DeviceType> imported_ranks,
-        Kokkos::View<unsigned int *, DeviceType> topo, unsigned int topo_id,
-        unsigned int size );
+        Kokkos::View<unsigned int *, DeviceType> permute, unsigned int offset,
+        unsigned int size, unsigned int topo_id );
+
+    /**
+     * Search the given points and store the results found on this processor.
+     * The results of a previous search are discarded.
+     */
+    void search( Kokkos::View<double **, DeviceType> points_coordinates,
+                 Kokkos::View<int *, DeviceType> query_ids );
 
     /**
      * Build the target-to-source distributor.
      */
-    void build_distributor( std::array<Kokkos::View<int *, DeviceType>,
-                                       DTK_N_TOPO> const &filtered_ranks );
+    void build_distributor();
+
+    /**
+     * Send the query ids of the results found on this processor to the
+     * processors owning the points. Return the imported query ids, the
+     * position of the results in the flattened results of the sending
+     * processor, and the rank of the sending processor.
+     */
+    std::tuple<Kokkos::View<int *, DeviceType>, Kokkos::View<int *, DeviceType>,
+               Kokkos::View<int *, DeviceType>>
+    sendResultsToPointOwners() const;
 
     template <typename T>
     friend class Interpolation;
 
     MPI_Comm _comm;
+    MeshSearchIndex<DeviceType> _mesh_index;
     ArborX::Details::Distributor<DeviceType> _target_to_source_distributor;
     unsigned int _dim;
+    unsigned int _n_points;
+    PointOrdering _ordering;
     std::array<Kokkos::View<Coordinate **, DeviceType>, DTK_N_TOPO>
         _reference_points;
     std::array<Kokkos::View<int *, DeviceType>, DTK_N_TOPO> _query_ids;
     std::array<Kokkos::View<int *, DeviceType>, DTK_N_TOPO> _cell_indices;
-    std::array<std::vector<unsigned int>, DTK_N_TOPO> _cell_indices_map;
+    std::array<Kokkos::View<int *, DeviceType>, DTK_N_TOPO> _ranks;
 };
 } // namespace DataTransferKit
 
@@ -16,6 +16,7 @@
 #include <DTK_DBC.hpp>
 #include <DTK_DiscretizationHelpers.hpp>
 #include <DTK_PointInCell.hpp>
+#include <DTK_PointOrdering.hpp>
 #include <DTK_Topology.hpp>
 
 #include <mpi.h>
@@ -85,6 +86,160 @@ void buildTopo( Kokkos::View<int *, DeviceType> imported_cell_indices,
 #endif
 }
 
+/**
+ * Stable counting sort of the imports by topology. On output, \p permute(k)
+ * is the index of the k-th import once sorted and the imports associated to
+ * topology \p topo_id are in [ \p topo_offset[topo_id], \p
+ * topo_offset[topo_id+1] ). The imports are processed by blocks: the number
+ * of imports of each topology is counted in every block, the counts are
+ * scanned in topology-major order, and every block then scatters its imports
+ * at the position given by the scan.
+ */
+template <typename DeviceType>
+std::array<unsigned int, DTK_N_TOPO + 1>
+sortByTopology( Kokkos::View<unsigned int *, DeviceType> topo,
+                Kokkos::View<unsigned int[DTK_N_TOPO], DeviceType> topo_size,
+                Kokkos::View<unsigned int *, DeviceType> permute )
+{
+    DTK_REQUIRE( permute.extent( 0 ) == topo.extent( 0 ) );
+
+    auto topo_size_host = Kokkos::create_mirror_view( topo_size );
+    Kokkos::deep_copy( topo_size_host, topo_size );
+    std::array<unsigned int, DTK_N_TOPO + 1> topo_offset;
+    topo_offset[0] = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+        topo_offset[topo_id + 1] =
+            topo_offset[topo_id] + topo_size_host( topo_id );
+
+    unsigned int const n_imports = topo.extent( 0 );
+    if ( n_imports == 0 )
+        return topo_offset;
+
+    unsigned int constexpr block_size = 256;
+    unsigned int const n_blocks = ( n_imports + block_size - 1 ) / block_size;
+    using ExecutionSpace = typename DeviceType::execution_space;
+    Kokkos::View<unsigned int *, DeviceType> block_count(
+        "block_count", DTK_N_TOPO * n_blocks );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "count_topo_per_block" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_blocks ),
+        KOKKOS_LAMBDA( int const b ) {
+            unsigned int const end = ( b + 1 ) * block_size < n_imports
+                                         ? ( b + 1 ) * block_size
+                                         : n_imports;
+            for ( unsigned int i = b * block_size; i < end; ++i )
+                ++block_count( topo( i ) * n_blocks + b );
+        } );
+    Kokkos::fence();
+
+    Kokkos::View<unsigned int *, DeviceType> block_offset(
+        "block_offset", DTK_N_TOPO * n_blocks );
+    ArborX::exclusivePrefixSum( block_count, block_offset );
+
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "scatter_topo_per_block" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_blocks ),
+        KOKKOS_LAMBDA( int const b ) {
+            unsigned int position[DTK_N_TOPO];
+            for ( unsigned int j = 0; j < DTK_N_TOPO; ++j )
+                position[j] = block_offset( j * n_blocks + b );
+            unsigned int const end = ( b + 1 ) * block_size < n_imports
+                                         ? ( b + 1 ) * block_size
+                                         : n_imports;
+            for ( unsigned int i = b * block_size; i < end; ++i )
+                permute( position[topo( i )]++ ) = i;
+        } );
+    Kokkos::fence();
+
+    return topo_offset;
+}
+
+/**
+ * Compute the position of the entries of \p flags equal to \p value once
+ * all the other entries have been removed. Return the number of entries
+ * equal to \p value.
+ */
+template <typename T, typename DeviceType>
+unsigned int
+computeCompactionOffset( Kokkos::View<T *, DeviceType> flags, T const value,
+                         Kokkos::View<unsigned int *, DeviceType> offset )
+{
+    DTK_REQUIRE( flags.extent( 0 ) == offset.extent( 0 ) );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    unsigned int n_selected = 0;
+    Kokkos::parallel_scan(
+        DTK_MARK_REGION( "compute_compaction_offset" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, flags.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const i, unsigned int &update,
+                       bool const final_pass ) {
+            if ( final_pass )
+                offset( i ) = update;
+            if ( flags( i ) == value )
+                ++update;
+        },
+        n_selected );
+
+    return n_selected;
+}
+
+/**
+ * Counting sort of the results by query id. The query ids are in [0, \p
+ * n_queries). On output, \p permute(k) is the index of the k-th result once
+ * sorted. The results associated to the same query keep their relative order.
+ */
+template <typename DeviceType>
+void sortByQueryIds( Kokkos::View<unsigned int *, DeviceType> query_ids,
+                     unsigned int const n_queries,
+                     Kokkos::View<unsigned int *, DeviceType> permute )
+{
+    DTK_REQUIRE( permute.extent( 0 ) == query_ids.extent( 0 ) );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    unsigned int const n_results = query_ids.extent( 0 );
+    Kokkos::View<unsigned int *, DeviceType> query_count( "query_count",
+                                                          n_queries + 1 );
+    Kokkos::parallel_for( DTK_MARK_REGION( "count_results_per_query" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_results ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              Kokkos::atomic_increment(
+                                  &query_count( query_ids( i ) ) );
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<unsigned int *, DeviceType> query_offset( "query_offset",
+                                                           n_queries + 1 );
+    ArborX::exclusivePrefixSum( query_count, query_offset );
+    Kokkos::deep_copy( query_count, query_offset );
+
+    Kokkos::parallel_for( DTK_MARK_REGION( "scatter_results_per_query" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_results ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              unsigned int const k = Kokkos::atomic_fetch_add(
+                                  &query_count( query_ids( i ) ), 1u );
+                              permute( k ) = i;
+                          } );
+    Kokkos::fence();
+
+    // The atomics do not preserve the order of the results of a given query.
+    // There are only a few of them so we sort them in place.
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "sort_results_of_query" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_queries ),
+        KOKKOS_LAMBDA( int const q ) {
+            for ( unsigned int k = query_offset( q ) + 1;
+                  k < query_offset( q + 1 ); ++k )
+            {
+                unsigned int const value = permute( k );
+                unsigned int l = k;
+                for ( ; l > query_offset( q ) && permute( l - 1 ) > value; --l )
+                    permute( l ) = permute( l - 1 );
+                permute( l ) = value;
+            }
+        } );
+    Kokkos::fence();
+}
+
 template <typename ViewType>
 void sendDataAcrossNetwork(
     ArborX::Details::Distributor<typename ViewType::device_type> const
@@ -106,6 +261,54 @@ void sendDataAcrossNetwork(
     sendDataAcrossNetwork( distributor, data... );
 }
 
+template <typename ViewType>
+ViewType concatenate( ViewType first, ViewType second )
+{
+    static_assert( ViewType::rank == 1, "concatenate expects rank-1 Views" );
+    unsigned int const n_first = first.extent( 0 );
+    unsigned int const n_second = second.extent( 0 );
+    ViewType result( second.label(), n_first + n_second );
+    Kokkos::deep_copy(
+        Kokkos::subview( result, Kokkos::make_pair( 0u, n_first ) ), first );
+    Kokkos::deep_copy( Kokkos::subview( result, Kokkos::make_pair(
+                                                    n_first,
+                                                    n_first + n_second ) ),
+                       second );
+
+    return result;
+}
+
+template <typename DeviceType>
+Kokkos::View<Coordinate **, DeviceType>
+concatenate( Kokkos::View<Coordinate **, DeviceType> first,
+             Kokkos::View<Coordinate **, DeviceType> second )
+{
+    DTK_REQUIRE( first.extent( 1 ) == second.extent( 1 ) ||
+                 first.extent( 0 ) == 0 || second.extent( 0 ) == 0 );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    unsigned int const n_first = first.extent( 0 );
+    unsigned int const n_second = second.extent( 0 );
+    unsigned int const dim =
+        ( n_first > 0 ) ? first.extent( 1 ) : second.extent( 1 );
+    Kokkos::View<Coordinate **, DeviceType> result(
+        second.label(), n_first + n_second, dim );
+    Kokkos::parallel_for( DTK_MARK_REGION( "concatenate" ),
+                          Kokkos::RangePolicy<ExecutionSpace>(
+                              0, n_first + n_second ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              for ( unsigned int d = 0; d < dim; ++d )
+                                  result( i, d ) =
+                                      ( static_cast<unsigned int>( i ) <
+                                        n_first )
+                                          ? first( i, d )
+                                          : second( i - n_first, d );
+                          } );
+    Kokkos::fence();
+
+    return result;
+}
+
 //  Return parameters points, cell_indices, query_ids,
 template <typename DeviceType>
 std::tuple<Kokkos::View<ArborX::Point *, DeviceType>,
@@ -116,6 +319,7 @@ moveDataFromSourceToTarget( MPI_Comm comm,
                             Kokkos::View<int *, DeviceType> offset,
                             Kokkos::View<int *, DeviceType> ranks,
                             Kokkos::View<double **, DeviceType> points_coord,
+                            Kokkos::View<int *, DeviceType> query_ids,
                             unsigned int dim )
 {
     using ExecutionSpace = typename DeviceType::execution_space;
@@ -141,7 +345,7 @@ moveDataFromSourceToTarget( MPI_Comm comm,
         KOKKOS_LAMBDA( int const i ) {
             for ( int j = offset( i ); j < offset( i + 1 ); ++j )
             {
-                exported_query_ids( j ) = i;
+                exported_query_ids( j ) = query_ids( i );
                 for ( unsigned int k = 0; k < dim; ++k )
                     exported_points( j )[k] = points_coord( i, k );
             }
@@ -177,44 +381,57 @@ moveDataFromSourceToTarget( MPI_Comm comm,
 template <typename DeviceType>
 PointSearch<DeviceType>::PointSearch(
     MPI_Comm comm, Mesh<DeviceType> const &mesh,
-    Kokkos::View<double **, DeviceType> points_coordinates )
-    : _comm( comm )
+    Kokkos::View<double **, DeviceType> points_coordinates,
+    PointOrdering ordering )
+    : PointSearch( MeshSearchIndex<DeviceType>( comm, mesh ),
+                   points_coordinates, ordering )
+{
+}
+
+template <typename DeviceType>
+PointSearch<DeviceType>::PointSearch(
+    MeshSearchIndex<DeviceType> const &mesh_index,
+    Kokkos::View<double **, DeviceType> points_coordinates,
+    PointOrdering ordering )
+    : _comm( mesh_index.getComm() )
+    , _mesh_index( mesh_index )
     , _target_to_source_distributor( _comm )
+    , _ordering( ordering )
 {
     DTK_REQUIRE( points_coordinates.extent( 1 ) ==
-                 mesh.nodes_coordinates.extent( 1 ) );
+                 mesh_index.getDimension() );
     _dim = points_coordinates.extent( 1 );
+    _n_points = points_coordinates.extent( 0 );
 
-    // Compute the number of cells of each of the supported topologies.
-    std::array<unsigned int, DTK_N_TOPO> n_cells_per_topo =
-        Discretization::Helpers::computeNCellsPerTopology(
-            mesh.cell_topologies );
+    Kokkos::View<int *, DeviceType> query_ids( "query_ids", _n_points );
+    ArborX::iota( query_ids );
+    search( points_coordinates, query_ids );
 
-    // Compute the topology and node offset
-    Discretization::Helpers::MeshOffsets<DeviceType> mesh_offsets( mesh );
+    // Build the _source_to_target_distributor
+    build_distributor();
 
-    // Convert the cells and cell_nodes_coordinates View to block_cells
-    auto n_nodes_per_topo_host =
-        Kokkos::create_mirror_view( mesh_offsets.n_nodes_per_topo );
-    Kokkos::deep_copy( n_nodes_per_topo_host, mesh_offsets.n_nodes_per_topo );
-    std::array<Kokkos::View<double ***, DeviceType>, DTK_N_TOPO> block_cells;
-    for ( int i = 0; i < DTK_N_TOPO; ++i )
-    {
-        block_cells[i] = Kokkos::View<double ***, DeviceType>(
-            "block_cells_" + std::to_string( i ), n_cells_per_topo[i],
-            n_nodes_per_topo_host( i ), _dim );
-    }
-    Discretization::Helpers::convertMesh( mesh, mesh_offsets, block_cells );
+    // Keep a single result for the points found in several cells
+    removeDuplicates();
+}
 
-    // Initialize bounding_box_to_cell to an invalid state
-    Kokkos::View<unsigned int **, DeviceType> bounding_box_to_cell(
-        "bounding_box_to_cell", mesh.cell_topologies.extent( 0 ), DTK_N_TOPO );
-    Kokkos::deep_copy( bounding_box_to_cell, static_cast<unsigned int>( -1 ) );
+template <typename DeviceType>
+void PointSearch<DeviceType>::search(
+    Kokkos::View<double **, DeviceType> points_coordinates,
+    Kokkos::View<int *, DeviceType> query_ids )
+{
+    auto const &block_cells = _mesh_index._block_cells;
+    auto bounding_box_to_cell = _mesh_index._bounding_box_to_cell;
 
-    Kokkos::View<ArborX::Box *, DeviceType> bounding_boxes(
-        "bounding_boxes", mesh.cell_topologies.extent( 0 ) );
-    Discretization::Helpers::createBoundingBoxes(
-        mesh, mesh_offsets, block_cells, bounding_boxes, bounding_box_to_cell );
+    // The results are identified by the query ids so the points can be
+    // searched for in any order.
+    if ( _ordering == PointOrdering::Morton )
+    {
+        auto const permutation =
+            Details::computeMortonPermutation<DeviceType>( points_coordinates );
+        points_coordinates =
+            Details::permuteRows( permutation, points_coordinates );
+        query_ids = Details::permuteRows( permutation, query_ids );
+    }
 
     // Perform the distributed search. At the end of the distributed search the
     // points are moved from the "source processors" to the "target processors".
@@ -228,7 +445,7 @@ PointSearch<DeviceType>::PointSearch(
         performDistributedSearch(
             ( _dim == 3 ) ? points_coordinates
                           : internal::convertPointDim( points_coordinates ),
-            bounding_boxes );
+            query_ids );
 
     // We need to separate the data for the different topologies because of
     // Intrepid2. Because a point can be found in multiple cells, we need to
@@ -238,31 +455,346 @@ PointSearch<DeviceType>::PointSearch(
     Kokkos::View<unsigned int[DTK_N_TOPO], DeviceType> topo_size( "topo_size" );
     internal::buildTopo( imported_cell_indices, bounding_box_to_cell, topo,
                          topo_size );
-    auto topo_size_host = Kokkos::create_mirror_view( topo_size );
-    Kokkos::deep_copy( topo_size_host, topo_size );
+    // Sort the imports by topology so that the data associated to each
+    // topology is contiguous.
+    Kokkos::View<unsigned int *, DeviceType> permute( "permute", n_imports );
+    std::array<unsigned int, DTK_N_TOPO + 1> const topo_offset =
+        internal::sortByTopology( topo, topo_size, permute );
 
-    std::array<Kokkos::View<int *, DeviceType>, DTK_N_TOPO> filtered_ranks;
     // Check if the points are in the cells
     for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+    {
+        _reference_points[topo_id] = Kokkos::View<Coordinate **, DeviceType>();
+        _query_ids[topo_id] = Kokkos::View<int *, DeviceType>();
+        _cell_indices[topo_id] = Kokkos::View<int *, DeviceType>();
+        _ranks[topo_id] = Kokkos::View<int *, DeviceType>();
         if ( block_cells[topo_id].extent( 0 ) != 0 )
         {
-            filtered_ranks[topo_id] = performPointInCell(
+            _ranks[topo_id] = performPointInCell(
                 block_cells[topo_id], bounding_box_to_cell,
                 imported_cell_indices, imported_points, imported_query_ids,
-                imported_ranks, topo, topo_id, topo_size_host( topo_id ) );
+                imported_ranks, permute, topo_offset[topo_id],
+                topo_offset[topo_id + 1] - topo_offset[topo_id], topo_id );
         }
+    }
+}
 
-    // Build the _source_to_target_distributor
-    build_distributor( filtered_ranks );
-
-    // Build a map between the cell_indices sorted by topology and the flat View
-    // given to the constructor
-    auto cell_topologies_host =
-        Kokkos::create_mirror_view( mesh.cell_topologies );
-    Kokkos::deep_copy( cell_topologies_host, mesh.cell_topologies );
-    unsigned int const size = cell_topologies_host.extent( 0 );
-    for ( unsigned int i = 0; i < size; ++i )
-        _cell_indices_map[cell_topologies_host( i )].push_back( i );
+template <typename DeviceType>
+void PointSearch<DeviceType>::update(
+    Kokkos::View<double **, DeviceType> points_coordinates )
+{
+    DTK_REQUIRE( points_coordinates.extent( 0 ) == _n_points );
+    DTK_REQUIRE( points_coordinates.extent( 1 ) == _dim );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    // Tell the processors owning the points where each of their points was
+    // found.
+    std::array<unsigned int, DTK_N_TOPO + 1> topo_offset;
+    topo_offset[0] = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+        topo_offset[topo_id + 1] =
+            topo_offset[topo_id] + _query_ids[topo_id].extent( 0 );
+    unsigned int const n_results = topo_offset[DTK_N_TOPO];
+    Kokkos::View<int *, DeviceType> imported_query_ids;
+    Kokkos::View<int *, DeviceType> imported_indices;
+    Kokkos::View<int *, DeviceType> imported_cell_ranks;
+    std::tie( imported_query_ids, imported_indices, imported_cell_ranks ) =
+        sendResultsToPointOwners();
+    unsigned int const n_imports = imported_query_ids.extent( 0 );
+
+    // Send the new coordinates of the points back to the processors owning
+    // the cells where they were found.
+    auto imported_cell_ranks_host =
+        Kokkos::create_mirror_view( imported_cell_ranks );
+    Kokkos::deep_copy( imported_cell_ranks_host, imported_cell_ranks );
+    ArborX::Details::Distributor<DeviceType> source_to_target_distributor(
+        _comm );
+    unsigned int const n_rechecks =
+        source_to_target_distributor.createFromSends(
+            imported_cell_ranks_host );
+    DTK_CHECK( n_rechecks == n_results );
+    Kokkos::View<ArborX::Point *, DeviceType> exported_points(
+        "exported_points", n_imports );
+    unsigned int dim = _dim;
+    Kokkos::parallel_for( DTK_MARK_REGION( "export_moved_points" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              for ( unsigned int d = 0; d < dim; ++d )
+                                  exported_points( i )[d] = points_coordinates(
+                                      imported_query_ids( i ), d );
+                          } );
+    Kokkos::fence();
+    Kokkos::View<ArborX::Point *, DeviceType> rechecked_points(
+        "rechecked_points", n_rechecks );
+    Kokkos::View<int *, DeviceType> rechecked_indices( "rechecked_indices",
+                                                       n_rechecks );
+    internal::sendDataAcrossNetwork(
+        source_to_target_distributor,
+        std::make_pair( exported_points, rechecked_points ),
+        std::make_pair( imported_indices, rechecked_indices ) );
+
+    // Check if the points are still in the cells where they were found. The
+    // results of the points that left their cells are filtered out.
+    Kokkos::View<double **, DeviceType> flat_points( "flat_points", n_results,
+                                                     _dim );
+    Kokkos::parallel_for( DTK_MARK_REGION( "scatter_moved_points" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_rechecks ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              for ( unsigned int d = 0; d < dim; ++d )
+                                  flat_points( rechecked_indices( i ), d ) =
+                                      rechecked_points( i )[d];
+                          } );
+    Kokkos::fence();
+    Kokkos::View<int *, DeviceType> still_in_cell( "still_in_cell",
+                                                   n_results );
+    Topologies topologies;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+    {
+        unsigned int const size = _query_ids[topo_id].extent( 0 );
+        if ( size == 0 )
+            continue;
+
+        unsigned int const offset = topo_offset[topo_id];
+        Kokkos::View<double **, DeviceType> topo_points( "topo_points", size,
+                                                         _dim );
+        Kokkos::parallel_for( DTK_MARK_REGION( "copy_moved_points" ),
+                              Kokkos::RangePolicy<ExecutionSpace>( 0, size ),
+                              KOKKOS_LAMBDA( int const i ) {
+                                  for ( unsigned int d = 0; d < dim; ++d )
+                                      topo_points( i, d ) =
+                                          flat_points( offset + i, d );
+                              } );
+        Kokkos::fence();
+
+        Kokkos::View<double **, DeviceType> topo_reference_points(
+            "topo_reference_points_" + std::to_string( topo_id ), size, _dim );
+        Kokkos::View<bool *, DeviceType> topo_point_in_cell(
+            "topo_point_in_cell_" + std::to_string( topo_id ), size );
+        PointInCell<DeviceType>::search(
+            topo_points, _mesh_index._block_cells[topo_id],
+            _cell_indices[topo_id], topologies[topo_id].topo,
+            topo_reference_points, topo_point_in_cell );
+        Kokkos::parallel_for( DTK_MARK_REGION( "copy_still_in_cell" ),
+                              Kokkos::RangePolicy<ExecutionSpace>( 0, size ),
+                              KOKKOS_LAMBDA( int const i ) {
+                                  still_in_cell( offset + i ) =
+                                      topo_point_in_cell( i ) ? 1 : 0;
+                              } );
+        Kokkos::fence();
+
+        _ranks[topo_id] = filterInCell(
+            topo_point_in_cell, topo_reference_points, _cell_indices[topo_id],
+            _query_ids[topo_id], _ranks[topo_id], topo_id );
+    }
+
+    // Tell the processors owning the points which points are still found.
+    Kokkos::View<int *, DeviceType> imported_still_in_cell(
+        "imported_still_in_cell", n_imports );
+    internal::sendDataAcrossNetwork(
+        _target_to_source_distributor,
+        std::make_pair( still_in_cell, imported_still_in_cell ) );
+    Kokkos::View<int *, DeviceType> found( "found", _n_points );
+    Kokkos::parallel_for( DTK_MARK_REGION( "mark_found_points" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              if ( imported_still_in_cell( i ) == 1 )
+                                  found( imported_query_ids( i ) ) = 1;
+                          } );
+    Kokkos::fence();
+
+    // Gather the points that need to be searched again
+    Kokkos::View<unsigned int *, DeviceType> lost_offset( "lost_offset",
+                                                          _n_points );
+    unsigned int const n_lost =
+        internal::computeCompactionOffset( found, 0, lost_offset );
+    unsigned int n_lost_global = 0;
+    MPI_Allreduce( &n_lost, &n_lost_global, 1, MPI_UNSIGNED, MPI_SUM, _comm );
+
+    // When all the points are still in their cells, only their reference
+    // coordinates changed and the distributor is still valid.
+    if ( n_lost_global == 0 )
+        return;
+
+    unsigned int const n_points = _n_points;
+    Kokkos::View<double **, DeviceType> lost_points( "lost_points", n_lost,
+                                                     _dim );
+    Kokkos::View<int *, DeviceType> lost_query_ids( "lost_query_ids", n_lost );
+    Kokkos::parallel_for( DTK_MARK_REGION( "gather_lost_points" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              if ( found( i ) == 0 )
+                              {
+                                  unsigned int const k = lost_offset( i );
+                                  lost_query_ids( k ) = i;
+                                  for ( unsigned int d = 0; d < dim; ++d )
+                                      lost_points( k, d ) =
+                                          points_coordinates( i, d );
+                              }
+                          } );
+    Kokkos::fence();
+
+    // Search the lost points and append the new results to the ones that are
+    // still valid.
+    auto const kept_reference_points = _reference_points;
+    auto const kept_query_ids = _query_ids;
+    auto const kept_cell_indices = _cell_indices;
+    auto const kept_ranks = _ranks;
+    search( lost_points, lost_query_ids );
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+    {
+        _reference_points[topo_id] = internal::concatenate(
+            kept_reference_points[topo_id], _reference_points[topo_id] );
+        _query_ids[topo_id] = internal::concatenate( kept_query_ids[topo_id],
+                                                     _query_ids[topo_id] );
+        _cell_indices[topo_id] = internal::concatenate(
+            kept_cell_indices[topo_id], _cell_indices[topo_id] );
+        _ranks[topo_id] =
+            internal::concatenate( kept_ranks[topo_id], _ranks[topo_id] );
+    }
+
+    // Rebuild the _target_to_source_distributor from the updated ranks. This
+    // only requires local work and the exchange of the message sizes.
+    build_distributor();
+
+    // The points that were searched again may have been found in several
+    // cells
+    removeDuplicates();
+}
+
+template <typename DeviceType>
+std::tuple<Kokkos::View<int *, DeviceType>, Kokkos::View<int *, DeviceType>,
+           Kokkos::View<int *, DeviceType>>
+PointSearch<DeviceType>::sendResultsToPointOwners() const
+{
+    int comm_rank;
+    MPI_Comm_rank( _comm, &comm_rank );
+
+    // Flatten the query ids of the results in the order used by
+    // _target_to_source_distributor.
+    std::array<unsigned int, DTK_N_TOPO + 1> topo_offset;
+    topo_offset[0] = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+        topo_offset[topo_id + 1] =
+            topo_offset[topo_id] + _query_ids[topo_id].extent( 0 );
+    unsigned int const n_results = topo_offset[DTK_N_TOPO];
+    Kokkos::View<int *, DeviceType> flat_query_ids( "flat_query_ids",
+                                                    n_results );
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+        Kokkos::deep_copy(
+            Kokkos::subview( flat_query_ids,
+                             Kokkos::make_pair( topo_offset[topo_id],
+                                                topo_offset[topo_id + 1] ) ),
+            _query_ids[topo_id] );
+    Kokkos::View<int *, DeviceType> flat_indices( "flat_indices", n_results );
+    ArborX::iota( flat_indices );
+    Kokkos::View<int *, DeviceType> cell_ranks( "cell_ranks", n_results );
+    Kokkos::deep_copy( cell_ranks, comm_rank );
+
+    unsigned int const n_imports =
+        _target_to_source_distributor.getTotalReceiveLength();
+    Kokkos::View<int *, DeviceType> imported_query_ids( "imported_query_ids",
+                                                        n_imports );
+    Kokkos::View<int *, DeviceType> imported_indices( "imported_indices",
+                                                      n_imports );
+    Kokkos::View<int *, DeviceType> imported_cell_ranks(
+        "imported_cell_ranks", n_imports );
+    internal::sendDataAcrossNetwork(
+        _target_to_source_distributor,
+        std::make_pair( flat_query_ids, imported_query_ids ),
+        std::make_pair( flat_indices, imported_indices ),
+        std::make_pair( cell_ranks, imported_cell_ranks ) );
+
+    return std::make_tuple( imported_query_ids, imported_indices,
+                            imported_cell_ranks );
+}
+
+template <typename DeviceType>
+void PointSearch<DeviceType>::removeDuplicates()
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    Kokkos::View<int *, DeviceType> imported_query_ids;
+    Kokkos::View<int *, DeviceType> imported_indices;
+    Kokkos::View<int *, DeviceType> imported_cell_ranks;
+    std::tie( imported_query_ids, imported_indices, imported_cell_ranks ) =
+        sendResultsToPointOwners();
+    unsigned int const n_imports = imported_query_ids.extent( 0 );
+
+    // For each point, keep the result with the lowest rank and, on this rank,
+    // the result that comes first.
+    using KeyType = unsigned long long;
+    Kokkos::View<KeyType *, DeviceType> best_key( "best_key", _n_points );
+    Kokkos::deep_copy( best_key, ~KeyType( 0 ) );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "find_best_result" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+        KOKKOS_LAMBDA( int const i ) {
+            KeyType const key =
+                ( static_cast<KeyType>( imported_cell_ranks( i ) ) << 32 ) |
+                static_cast<unsigned int>( imported_indices( i ) );
+            Kokkos::atomic_fetch_min( &best_key( imported_query_ids( i ) ),
+                                      key );
+        } );
+    Kokkos::fence();
+    Kokkos::View<int *, DeviceType> keep( "keep", n_imports );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "mark_best_result" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+        KOKKOS_LAMBDA( int const i ) {
+            KeyType const key =
+                ( static_cast<KeyType>( imported_cell_ranks( i ) ) << 32 ) |
+                static_cast<unsigned int>( imported_indices( i ) );
+            keep( i ) = ( best_key( imported_query_ids( i ) ) == key ) ? 1 : 0;
+        } );
+    Kokkos::fence();
+
+    // Send the decision back to the processors owning the cells
+    auto imported_cell_ranks_host =
+        Kokkos::create_mirror_view( imported_cell_ranks );
+    Kokkos::deep_copy( imported_cell_ranks_host, imported_cell_ranks );
+    ArborX::Details::Distributor<DeviceType> source_to_target_distributor(
+        _comm );
+    unsigned int const n_results =
+        source_to_target_distributor.createFromSends(
+            imported_cell_ranks_host );
+    Kokkos::View<int *, DeviceType> result_keep( "result_keep", n_results );
+    Kokkos::View<int *, DeviceType> result_indices( "result_indices",
+                                                    n_results );
+    internal::sendDataAcrossNetwork(
+        source_to_target_distributor, std::make_pair( keep, result_keep ),
+        std::make_pair( imported_indices, result_indices ) );
+    Kokkos::View<bool *, DeviceType> flat_keep( "flat_keep", n_results );
+    Kokkos::parallel_for( DTK_MARK_REGION( "scatter_keep" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_results ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              flat_keep( result_indices( i ) ) =
+                                  ( result_keep( i ) == 1 );
+                          } );
+    Kokkos::fence();
+
+    // Prune the results
+    unsigned int offset = 0;
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+    {
+        unsigned int const size = _query_ids[topo_id].extent( 0 );
+        if ( size == 0 )
+            continue;
+
+        Kokkos::View<bool *, DeviceType> topo_keep(
+            "topo_keep_" + std::to_string( topo_id ), size );
+        Kokkos::deep_copy(
+            topo_keep,
+            Kokkos::subview( flat_keep,
+                             Kokkos::make_pair( offset, offset + size ) ) );
+        _ranks[topo_id] =
+            filterInCell( topo_keep, _reference_points[topo_id],
+                          _cell_indices[topo_id], _query_ids[topo_id],
+                          _ranks[topo_id], topo_id );
+        offset += size;
+    }
+
+    build_distributor();
 }
 
 template <typename DeviceType>
@@ -282,7 +814,6 @@ PointSearch<DeviceType>::getSearchResults() const
     MPI_Comm_rank( _comm, &comm_rank );
     Kokkos::deep_copy( ranks, comm_rank );
     Kokkos::View<int *, DeviceType> cell_indices( "cell_indices", n_ref_pts );
-    auto cell_indices_host = Kokkos::create_mirror_view( cell_indices );
     Kokkos::View<unsigned int *, DeviceType> query_ids( "query_ids",
                                                         n_ref_pts );
     Kokkos::View<ArborX::Point *, DeviceType> ref_pts( "ref_pts", n_ref_pts );
@@ -291,16 +822,17 @@ PointSearch<DeviceType>::getSearchResults() const
     {
         unsigned int const size = _query_ids[topo_id].extent( 0 );
 
-        // First fill cell_indices. This has to be done on the host because
-        // _cell_indices_map only exists on the host.
-        auto topo_cell_indices_host =
-            Kokkos::create_mirror_view( _cell_indices[topo_id] );
-        Kokkos::deep_copy( topo_cell_indices_host, _cell_indices[topo_id] );
-        for ( unsigned int i = 0; i < size; ++i )
-        {
-            cell_indices_host( i + n_copied_pts ) =
-                _cell_indices_map[topo_id][topo_cell_indices_host( i )];
-        }
+        // First fill cell_indices
+        auto topo_cell_indices = _cell_indices[topo_id];
+        auto cell_indices_map = _mesh_index._cell_indices_map[topo_id];
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "cell_indices" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, size ),
+            KOKKOS_LAMBDA( int const i ) {
+                cell_indices( i + n_copied_pts ) =
+                    cell_indices_map( topo_cell_indices( i ) );
+            } );
+        Kokkos::fence();
 
         // Fill query_ids
         auto topo_query_ids = _query_ids[topo_id];
@@ -326,7 +858,6 @@ PointSearch<DeviceType>::getSearchResults() const
 
         n_copied_pts += size;
     }
-    Kokkos::deep_copy( cell_indices, cell_indices_host );
 
     // Communicate the results
     unsigned int n_imports =
@@ -346,9 +877,32 @@ PointSearch<DeviceType>::getSearchResults() const
         std::make_pair( ref_pts, imported_ref_pts ),
         std::make_pair( query_ids, imported_query_ids ) );
 
-    ArborX::Details::DistributedSearchTreeImpl<DeviceType>::sortResults(
-        imported_query_ids, imported_query_ids, imported_cell_indices,
-        imported_ranks, imported_ref_pts );
+    // The query ids are dense so the results are put back in the order of the
+    // queries with a counting sort.
+    Kokkos::View<unsigned int *, DeviceType> permute( "permute", n_imports );
+    internal::sortByQueryIds( imported_query_ids, _n_points, permute );
+    Kokkos::View<int *, DeviceType> sorted_ranks( "sorted_ranks", n_imports );
+    Kokkos::View<int *, DeviceType> sorted_cell_indices( "sorted_cell_indices",
+                                                         n_imports );
+    Kokkos::View<ArborX::Point *, DeviceType> sorted_ref_pts( "sorted_ref_pts",
+                                                              n_imports );
+    Kokkos::View<unsigned int *, DeviceType> sorted_query_ids(
+        "sorted_query_ids", n_imports );
+    Kokkos::parallel_for( DTK_MARK_REGION( "permute_results" ),
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              unsigned int const j = permute( i );
+                              sorted_ranks( i ) = imported_ranks( j );
+                              sorted_cell_indices( i ) =
+                                  imported_cell_indices( j );
+                              sorted_ref_pts( i ) = imported_ref_pts( j );
+                              sorted_query_ids( i ) = imported_query_ids( j );
+                          } );
+    Kokkos::fence();
+    imported_ranks = sorted_ranks;
+    imported_cell_indices = sorted_cell_indices;
+    imported_ref_pts = sorted_ref_pts;
+    imported_query_ids = sorted_query_ids;
 
 #if HAVE_DTK_DBC
     // Check that ranks and cell indices are positive
@@ -380,12 +934,10 @@ std::tuple<Kokkos::View<ArborX::Point *, DeviceType>,
            Kokkos::View<int *, DeviceType>>
 PointSearch<DeviceType>::performDistributedSearch(
     Kokkos::View<double **, DeviceType> points_coord,
-    Kokkos::View<ArborX::Box *, DeviceType> bounding_boxes )
+    Kokkos::View<int *, DeviceType> query_ids )
 {
     DTK_REQUIRE( points_coord.extent( 1 ) == 3 );
-
-    ArborX::DistributedSearchTree<DeviceType> distributed_tree(
-        _comm, bounding_boxes );
+    DTK_REQUIRE( query_ids.extent( 0 ) == points_coord.extent( 0 ) );
 
     unsigned int const n_points = points_coord.extent( 0 );
 
@@ -408,33 +960,31 @@ PointSearch<DeviceType>::performDistributedSearch(
     Kokkos::View<int *, DeviceType> indices( "indices" );
     Kokkos::View<int *, DeviceType> offset( "offset" );
     Kokkos::View<int *, DeviceType> ranks( "ranks" );
-    distributed_tree.query( queries, indices, offset, ranks );
+    _mesh_index._distributed_tree.query( queries, indices, offset, ranks );
 
     // Move the points from the source processors to the target processors
-    return internal::moveDataFromSourceToTarget( _comm, indices, offset, ranks,
-                                                 points_coord, _dim );
+    return internal::moveDataFromSourceToTarget(
+        _comm, indices, offset, ranks, points_coord, query_ids, _dim );
 }
 
 template <typename DeviceType>
 std::tuple<Kokkos::View<int *, DeviceType>, Kokkos::View<double **, DeviceType>,
            Kokkos::View<int *, DeviceType>, Kokkos::View<int *, DeviceType>>
 PointSearch<DeviceType>::filterTopology(
-    Kokkos::View<unsigned int *, DeviceType> topo, unsigned int topo_id,
-    unsigned int size,
+    Kokkos::View<unsigned int *, DeviceType> permute, unsigned int offset,
+    unsigned int size, unsigned int topo_id,
     Kokkos::View<unsigned int **, DeviceType> bounding_box_to_cell,
     Kokkos::View<int *, DeviceType> cell_indices,
     Kokkos::View<ArborX::Point *, DeviceType> points,
     Kokkos::View<int *, DeviceType> query_ids,
     Kokkos::View<int *, DeviceType> ranks )
 {
-    DTK_REQUIRE( topo.extent( 0 ) == ranks.extent( 0 ) );
+    DTK_REQUIRE( permute.extent( 0 ) == ranks.extent( 0 ) );
     DTK_REQUIRE( query_ids.extent( 0 ) == ranks.extent( 0 ) );
+    DTK_REQUIRE( offset + size <= permute.extent( 0 ) );
     DTK_REQUIRE( bounding_box_to_cell.extent( 1 ) > topo_id );
 
     using ExecutionSpace = typename DeviceType::execution_space;
-    unsigned int const n_imports = topo.extent( 0 );
-    Kokkos::View<unsigned int *, DeviceType> offset( "offset", n_imports );
-    Discretization::Helpers::computeOffset( topo, topo_id, offset );
 
     // Create Kokkos::View with the points and the cell indices associated
     // with cells of topo_id topology. Also transform 3D points back to 2D
@@ -449,18 +999,15 @@ PointSearch<DeviceType>::filterTopology(
         "filtered_per_topo_ranks_" + std::to_string( topo_id ), size );
     unsigned int dim = _dim;
     Kokkos::parallel_for(
-        "filter_data", Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
-        KOKKOS_LAMBDA( int const i ) {
-            if ( topo( i ) == topo_id )
-            {
-                unsigned int const k = offset( i );
-                filtered_per_topo_cell_indices( k ) =
-                    bounding_box_to_cell( cell_indices( i ), topo_id );
-                for ( unsigned int j = 0; j < dim; ++j )
-                    filtered_per_topo_points( k, j ) = points( i )[j];
-                filtered_per_topo_query_ids( k ) = query_ids( i );
-                filtered_per_topo_ranks( k ) = ranks( i );
-            }
+        "filter_data", Kokkos::RangePolicy<ExecutionSpace>( 0, size ),
+        KOKKOS_LAMBDA( int const k ) {
+            unsigned int const i = permute( offset + k );
+            filtered_per_topo_cell_indices( k ) =
+                bounding_box_to_cell( cell_indices( i ), topo_id );
+            for ( unsigned int j = 0; j < dim; ++j )
+                filtered_per_topo_points( k, j ) = points( i )[j];
+            filtered_per_topo_query_ids( k ) = query_ids( i );
+            filtered_per_topo_ranks( k ) = ranks( i );
         } );
     Kokkos::fence();
 
@@ -485,17 +1032,12 @@ Kokkos::View<int *, DeviceType> PointSearch<DeviceType>::filterInCell(
     unsigned int n_ref_points = filtered_per_topo_point_in_cell.extent( 0 );
     if ( n_ref_points != 0 )
     {
-        int n_filtered_ref_points = 0;
         Kokkos::View<bool *, DeviceType> pt_in_cell =
             filtered_per_topo_point_in_cell;
-        Kokkos::parallel_reduce(
-            DTK_MARK_REGION( "compute_n_ref_pts" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_ref_points ),
-            KOKKOS_LAMBDA( int i, int &partial_sum ) {
-                if ( pt_in_cell[i] == true )
-                    partial_sum += 1;
-            },
-            n_filtered_ref_points );
+        Kokkos::View<unsigned int *, DeviceType> offset( "offset",
+                                                         n_ref_points );
+        unsigned int const n_filtered_ref_points =
+            internal::computeCompactionOffset( pt_in_cell, true, offset );
 
         // We are only interested in points that belong to the cells. So we
         // need to filter out all the points that were false positive of
@@ -512,9 +1054,6 @@ Kokkos::View<int *, DeviceType> PointSearch<DeviceType>::filterInCell(
         Kokkos::View<int *, DeviceType> query_ids = _query_ids[topo_id];
         Kokkos::View<int *, DeviceType> cell_indices = _cell_indices[topo_id];
 
-        Kokkos::View<unsigned int *, DeviceType> offset( "offset",
-                                                         n_ref_points );
-        Discretization::Helpers::computeOffset( pt_in_cell, true, offset );
         Kokkos::parallel_for(
             DTK_MARK_REGION( "filter" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_ref_points ),
@@ -544,8 +1083,8 @@ Kokkos::View<int *, DeviceType> PointSearch<DeviceType>::performPointInCell(
     Kokkos::View<ArborX::Point *, DeviceType> imported_points,
     Kokkos::View<int *, DeviceType> imported_query_ids,
     Kokkos::View<int *, DeviceType> imported_ranks,
-    Kokkos::View<unsigned int *, DeviceType> topo, unsigned int topo_id,
-    unsigned int size )
+    Kokkos::View<unsigned int *, DeviceType> permute, unsigned int offset,
+    unsigned int size, unsigned int topo_id )
 {
     // Filter the data for a given topology
     Kokkos::View<double **, DeviceType> filtered_per_topo_points;
@@ -554,7 +1093,7 @@ Kokkos::View<int *, DeviceType> PointSearch<DeviceType>::performPointInCell(
     Kokkos::View<int *, DeviceType> filtered_per_topo_ranks;
     std::tie( filtered_per_topo_cell_indices, filtered_per_topo_points,
               filtered_per_topo_query_ids, filtered_per_topo_ranks ) =
-        filterTopology( topo, topo_id, size, bounding_box_to_cell,
+        filterTopology( permute, offset, size, topo_id, bounding_box_to_cell,
                         imported_cell_indices, imported_points,
                         imported_query_ids, imported_ranks );
 
@@ -581,25 +1120,27 @@ Kokkos::View<int *, DeviceType> PointSearch<DeviceType>::performPointInCell(
 }
 
 template <typename DeviceType>
-void PointSearch<DeviceType>::build_distributor(
-    std::array<Kokkos::View<int *, DeviceType>, DTK_N_TOPO> const
-        &filtered_ranks )
+void PointSearch<DeviceType>::build_distributor()
 {
     // Flatten the filtered ranks to be used by the distributor
-    std::vector<int> flatten_ranks;
+    std::array<unsigned int, DTK_N_TOPO + 1> topo_offset;
+    topo_offset[0] = 0;
     for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
-    {
-        auto rank_host = Kokkos::create_mirror_view( filtered_ranks[topo_id] );
-        Kokkos::deep_copy( rank_host, filtered_ranks[topo_id] );
-        unsigned int const rank_host_size = rank_host.size();
-        for ( unsigned int i = 0; i < rank_host_size; ++i )
-            flatten_ranks.push_back( rank_host( i ) );
-    }
-
-    _target_to_source_distributor.createFromSends(
-        Kokkos::View<int const *, Kokkos::HostSpace,
-                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
-            flatten_ranks.data(), flatten_ranks.size() ) );
+        topo_offset[topo_id + 1] =
+            topo_offset[topo_id] + _ranks[topo_id].extent( 0 );
+    Kokkos::View<int *, DeviceType> flatten_ranks( "flatten_ranks",
+                                                   topo_offset[DTK_N_TOPO] );
+    for ( unsigned int topo_id = 0; topo_id < DTK_N_TOPO; ++topo_id )
+        Kokkos::deep_copy(
+            Kokkos::subview( flatten_ranks,
+                             Kokkos::make_pair( topo_offset[topo_id],
+                                                topo_offset[topo_id + 1] ) ),
+            _ranks[topo_id] );
+
+    // The distributor needs the ranks on the host
+    auto flatten_ranks_host = Kokkos::create_mirror_view( flatten_ranks );
+    Kokkos::deep_copy( flatten_ranks_host, flatten_ranks );
+    _target_to_source_distributor.createFromSends( flatten_ranks_host );
 }
 } // namespace DataTransferKit
 
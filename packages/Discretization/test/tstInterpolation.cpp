@@ -168,6 +168,13 @@ Kokkos::View<double *[2], DeviceType> getPointsCoord2D( MPI_Comm comm ) {
 
 // The `out` and `success` parameters come from the Teuchos unit testing macros
 // expansion.
+template <typename FEType, typename ExecutionSpace>
+unsigned int getBasisCardinality()
+{
+    typename FEType::template basis_type<ExecutionSpace, double, double> basis;
+    return basis.getCardinality();
+}
+
 template <int dim, typename DeviceType>
 void checkReferencePoints(
     Kokkos::View<ArborX::Point *, DeviceType> phys_points,
@@ -301,6 +308,261 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation, one_topo_one_fe_three_dim,
     {
         TEST_EQUALITY( Y.extent( 0 ), 0 );
     }
+
+    // Split the interpolation in two steps
+    Kokkos::View<double **, DeviceType> split_Y( "split_Y", n_points,
+                                                 n_fields );
+    interpolation.applyBegin( X, split_Y );
+    interpolation.applyEnd( split_Y );
+    auto Y_host = Kokkos::create_mirror_view( Y );
+    Kokkos::deep_copy( Y_host, Y );
+    auto split_Y_host = Kokkos::create_mirror_view( split_Y );
+    Kokkos::deep_copy( split_Y_host, split_Y );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        TEST_EQUALITY( split_Y_host( i, 0 ), Y_host( i, 0 ) );
+
+    // Interpolate in single precision
+    Kokkos::View<float **, DeviceType> float_X( "float_X", n_dofs, n_fields );
+    Kokkos::parallel_for( "initialize_float_X",
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_dofs ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              float_X( i, 0 ) = X( i, 0 );
+                          } );
+    Kokkos::fence();
+    Kokkos::View<float **, DeviceType> float_Y( "float_Y", n_points,
+                                                n_fields );
+    interpolation.apply( float_X, float_Y );
+    auto float_Y_host = Kokkos::create_mirror_view( float_Y );
+    Kokkos::deep_copy( float_Y_host, float_Y );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        TEST_FLOATING_EQUALITY( static_cast<double>( float_Y_host( i, 0 ) ),
+                                Y_host( i, 0 ), 1e-6 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation,
+                                   one_topo_one_fe_three_dim_many_fields,
+                                   DeviceType )
+{
+    // Same as one_topo_one_fe_three_dim but with enough fields to use the
+    // team interpolation kernel.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    unsigned int constexpr dim = 3;
+    Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies;
+    Kokkos::View<unsigned int *, DeviceType> cells;
+    Kokkos::View<double **, DeviceType> coordinates;
+    Kokkos::View<double * [3], DeviceType> points_coord;
+    std::vector<unsigned int> n_subdivisions = {{5, 5, 3}};
+    std::tie( cell_topologies, cells, coordinates ) =
+        buildStructuredMesh<DeviceType>( comm, n_subdivisions );
+    points_coord = getPointsCoord3D<DeviceType>( comm );
+    unsigned int const n_points = points_coord.extent( 0 );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    unsigned int const n_dofs = coordinates.extent( 0 );
+    unsigned int const n_fields = 8;
+    Kokkos::View<DataTransferKit::LocalOrdinal *, DeviceType> cell_dofs_ids(
+        "cell_dofs_ids", cells.extent( 0 ) );
+
+    Kokkos::parallel_for(
+        "initialize_cell_dofs_ids",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, cells.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const i ) { cell_dofs_ids( i ) = cells( i ); } );
+    Kokkos::fence();
+
+    DataTransferKit::Mesh<DeviceType> mesh( cell_topologies, cells,
+                                            coordinates );
+    DataTransferKit::Interpolation<DeviceType> interpolation(
+        comm, mesh, points_coord, cell_dofs_ids, DTK_HGRAD );
+
+    // We set X_j = x + y + z + 3 * j
+    Kokkos::View<double **, DeviceType> X( "X", n_dofs, n_fields );
+    Kokkos::parallel_for( "initialize_X",
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_dofs ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              double sum = 0.;
+                              for ( unsigned int d = 0; d < dim; ++d )
+                                  sum += coordinates( i, d );
+                              for ( unsigned int j = 0; j < n_fields; ++j )
+                                  X( i, j ) = sum + dim * j;
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<double **, DeviceType> Y( "Y", n_points, n_fields );
+    interpolation.apply( X, Y );
+    if ( comm_rank == 0 )
+    {
+        std::array<double, 5> ref_sol = {{1.5, 7.25, 8.0, 7.5, 6.}};
+        checkFieldValue<dim, 5>( ref_sol, Y, success, out );
+    }
+    else if ( comm_rank == 1 )
+    {
+        std::array<double, 5> ref_sol = {{4.5, 10.25, 11.0, 10.5, 9}};
+        checkFieldValue<dim, 5>( ref_sol, Y, success, out );
+    }
+    else
+    {
+        TEST_EQUALITY( Y.extent( 0 ), 0 );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation, one_topo_one_fe_gradient,
+                                   DeviceType )
+{
+    MPI_Comm comm = MPI_COMM_WORLD;
+    unsigned int constexpr dim = 3;
+    Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies;
+    Kokkos::View<unsigned int *, DeviceType> cells;
+    Kokkos::View<double **, DeviceType> coordinates;
+    Kokkos::View<double * [3], DeviceType> points_coord;
+    std::vector<unsigned int> n_subdivisions = {{5, 5, 3}};
+    std::tie( cell_topologies, cells, coordinates ) =
+        buildStructuredMesh<DeviceType>( comm, n_subdivisions );
+    points_coord = getPointsCoord3D<DeviceType>( comm );
+    unsigned int const n_points = points_coord.extent( 0 );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    unsigned int const n_dofs = coordinates.extent( 0 );
+    unsigned int const n_fields = 2;
+    Kokkos::View<DataTransferKit::LocalOrdinal *, DeviceType> cell_dofs_ids(
+        "cell_dofs_ids", cells.extent( 0 ) );
+
+    Kokkos::parallel_for(
+        "initialize_cell_dofs_ids",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, cells.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const i ) { cell_dofs_ids( i ) = cells( i ); } );
+    Kokkos::fence();
+
+    DataTransferKit::Mesh<DeviceType> mesh( cell_topologies, cells,
+                                            coordinates );
+    DataTransferKit::Interpolation<DeviceType> interpolation(
+        comm, mesh, points_coord, cell_dofs_ids, DTK_HGRAD );
+
+    // We set X_0 = x + 2y + 3z and X_1 = 3x - y
+    Kokkos::View<double **, DeviceType> X( "X", n_dofs, n_fields );
+    Kokkos::parallel_for( "initialize_X",
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_dofs ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              X( i, 0 ) = coordinates( i, 0 ) +
+                                          2. * coordinates( i, 1 ) +
+                                          3. * coordinates( i, 2 );
+                              X( i, 1 ) = 3. * coordinates( i, 0 ) -
+                                          coordinates( i, 1 );
+                          } );
+    Kokkos::fence();
+
+    // The values must be the same as the ones computed without the gradients
+    Kokkos::View<double **, DeviceType> Y_ref( "Y_ref", n_points, n_fields );
+    auto ref_query_ids = interpolation.apply( X, Y_ref );
+    auto ref_query_ids_host = Kokkos::create_mirror_view( ref_query_ids );
+    Kokkos::deep_copy( ref_query_ids_host, ref_query_ids );
+    Kokkos::View<double **, DeviceType> Y( "Y", n_points, n_fields );
+    Kokkos::View<double ***, DeviceType> grad_Y( "grad_Y", n_points, n_fields,
+                                                 dim );
+    auto query_ids = interpolation.apply( X, Y, grad_Y );
+    auto query_ids_host = Kokkos::create_mirror_view( query_ids );
+    Kokkos::deep_copy( query_ids_host, query_ids );
+
+    auto Y_ref_host = Kokkos::create_mirror_view( Y_ref );
+    Kokkos::deep_copy( Y_ref_host, Y_ref );
+    auto Y_host = Kokkos::create_mirror_view( Y );
+    Kokkos::deep_copy( Y_host, Y );
+    auto grad_Y_host = Kokkos::create_mirror_view( grad_Y );
+    Kokkos::deep_copy( grad_Y_host, grad_Y );
+    std::array<std::array<double, dim>, n_fields> ref_gradient = {
+        {{{1., 2., 3.}}, {{3., -1., 0.}}}};
+    for ( unsigned int i = 0; i < n_points; ++i )
+    {
+        TEST_EQUALITY( query_ids_host( i ), ref_query_ids_host( i ) );
+        if ( query_ids_host( i ) == -1 )
+            continue;
+        for ( unsigned int j = 0; j < n_fields; ++j )
+        {
+            TEST_FLOATING_EQUALITY( Y_host( i, j ), Y_ref_host( i, j ),
+                                    1e-14 );
+            for ( unsigned int d = 0; d < dim; ++d )
+                TEST_ASSERT( std::abs( grad_Y_host( i, j, d ) -
+                                       ref_gradient[j][d] ) < 1e-12 );
+        }
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation, one_topo_one_fe_transpose,
+                                   DeviceType )
+{
+    MPI_Comm comm = MPI_COMM_WORLD;
+    Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies;
+    Kokkos::View<unsigned int *, DeviceType> cells;
+    Kokkos::View<double **, DeviceType> coordinates;
+    Kokkos::View<double * [3], DeviceType> points_coord;
+    std::vector<unsigned int> n_subdivisions = {{5, 5, 3}};
+    std::tie( cell_topologies, cells, coordinates ) =
+        buildStructuredMesh<DeviceType>( comm, n_subdivisions );
+    points_coord = getPointsCoord3D<DeviceType>( comm );
+    unsigned int const n_points = points_coord.extent( 0 );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    unsigned int const n_dofs = coordinates.extent( 0 );
+    unsigned int const n_fields = 2;
+    Kokkos::View<DataTransferKit::LocalOrdinal *, DeviceType> cell_dofs_ids(
+        "cell_dofs_ids", cells.extent( 0 ) );
+
+    Kokkos::parallel_for(
+        "initialize_cell_dofs_ids",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, cells.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const i ) { cell_dofs_ids( i ) = cells( i ); } );
+    Kokkos::fence();
+
+    DataTransferKit::Mesh<DeviceType> mesh( cell_topologies, cells,
+                                            coordinates );
+    DataTransferKit::Interpolation<DeviceType> interpolation(
+        comm, mesh, points_coord, cell_dofs_ids, DTK_HGRAD );
+
+    Kokkos::View<double **, DeviceType> X( "X", n_dofs, n_fields );
+    Kokkos::parallel_for( "initialize_X",
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_dofs ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              X( i, 0 ) = coordinates( i, 0 ) +
+                                          coordinates( i, 1 ) +
+                                          coordinates( i, 2 );
+                              X( i, 1 ) = coordinates( i, 0 ) *
+                                          coordinates( i, 2 );
+                          } );
+    Kokkos::fence();
+    Kokkos::View<double **, DeviceType> Y( "Y", n_points, n_fields );
+    Kokkos::parallel_for( "initialize_Y",
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              Y( i, 0 ) = i + 1.;
+                              Y( i, 1 ) = 2. - i;
+                          } );
+    Kokkos::fence();
+
+    // Check that <A X, Y> = <X, A^T Y>
+    Kokkos::View<double **, DeviceType> AX( "AX", n_points, n_fields );
+    interpolation.apply( X, AX );
+    Kokkos::View<double **, DeviceType> ATY( "ATY", n_dofs, n_fields );
+    interpolation.applyTranspose( Y, ATY );
+
+    double local_dot[2] = {0., 0.};
+    Kokkos::parallel_reduce(
+        "dot_AX_Y", Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+        KOKKOS_LAMBDA( int const i, double &update ) {
+            for ( unsigned int j = 0; j < n_fields; ++j )
+                update += AX( i, j ) * Y( i, j );
+        },
+        local_dot[0] );
+    Kokkos::parallel_reduce(
+        "dot_X_ATY", Kokkos::RangePolicy<ExecutionSpace>( 0, n_dofs ),
+        KOKKOS_LAMBDA( int const i, double &update ) {
+            for ( unsigned int j = 0; j < n_fields; ++j )
+                update += X( i, j ) * ATY( i, j );
+        },
+        local_dot[1] );
+    double dot[2] = {0., 0.};
+    MPI_Allreduce( local_dot, dot, 2, MPI_DOUBLE, MPI_SUM, comm );
+    TEST_FLOATING_EQUALITY( dot[0], dot[1], 1e-12 );
 }
 
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation, two_topo_two_dim, DeviceType )
@@ -516,6 +778,187 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation,
     }
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation, update, DeviceType )
+{
+    // Move the points, some of them within the cell where they were found and
+    // some of them to another cell. The updated interpolation must give the
+    // same results as an interpolation built at the new positions.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    unsigned int constexpr dim = 3;
+    Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies;
+    Kokkos::View<unsigned int *, DeviceType> cells;
+    Kokkos::View<double **, DeviceType> coordinates;
+    Kokkos::View<double * [3], DeviceType> points_coord;
+    std::vector<unsigned int> n_subdivisions = {{5, 5, 3}};
+    std::tie( cell_topologies, cells, coordinates ) =
+        buildStructuredMesh<DeviceType>( comm, n_subdivisions );
+    points_coord = getPointsCoord3D<DeviceType>( comm );
+    unsigned int const n_points = points_coord.extent( 0 );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    unsigned int const n_dofs = coordinates.extent( 0 );
+    unsigned int const n_fields = 2;
+    Kokkos::View<DataTransferKit::LocalOrdinal *, DeviceType> cell_dofs_ids(
+        "cell_dofs_ids", cells.extent( 0 ) );
+
+    Kokkos::parallel_for(
+        "initialize_cell_dofs_ids",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, cells.extent( 0 ) ),
+        KOKKOS_LAMBDA( int const i ) { cell_dofs_ids( i ) = cells( i ); } );
+    Kokkos::fence();
+
+    DataTransferKit::Mesh<DeviceType> mesh( cell_topologies, cells,
+                                            coordinates );
+    DataTransferKit::Interpolation<DeviceType> interpolation(
+        comm, mesh, points_coord, cell_dofs_ids, DTK_HGRAD );
+
+    // We set X_0 = x + 2y + 3z and X_1 = 3x - y
+    Kokkos::View<double **, DeviceType> X( "X", n_dofs, n_fields );
+    Kokkos::View<float **, DeviceType> float_X( "float_X", n_dofs, n_fields );
+    Kokkos::parallel_for( "initialize_X",
+                          Kokkos::RangePolicy<ExecutionSpace>( 0, n_dofs ),
+                          KOKKOS_LAMBDA( int const i ) {
+                              X( i, 0 ) = coordinates( i, 0 ) +
+                                          2. * coordinates( i, 1 ) +
+                                          3. * coordinates( i, 2 );
+                              X( i, 1 ) = 3. * coordinates( i, 0 ) -
+                                          coordinates( i, 1 );
+                              for ( unsigned int j = 0; j < n_fields; ++j )
+                                  float_X( i, j ) = X( i, j );
+                          } );
+    Kokkos::fence();
+
+    // Use the single precision basis values and the gradients of the basis
+    // functions before the update so that they must be recomputed.
+    Kokkos::View<double **, DeviceType> Y( "Y", n_points, n_fields );
+    Kokkos::View<double ***, DeviceType> grad_Y( "grad_Y", n_points, n_fields,
+                                                 dim );
+    Kokkos::View<float **, DeviceType> float_Y( "float_Y", n_points,
+                                                n_fields );
+    interpolation.apply( X, Y, grad_Y );
+    interpolation.apply( float_X, float_Y );
+
+    // The point in the center of a cell stays in it, the point off the center
+    // moves to the next cell along x, and the points on a face, an edge, and
+    // a vertex move inside one of the cells they belonged to.
+    auto points_coord_host = Kokkos::create_mirror_view( points_coord );
+    Kokkos::deep_copy( points_coord_host, points_coord );
+    Kokkos::View<double **, DeviceType> new_points_coord( "new_points_coord",
+                                                          n_points, dim );
+    auto new_points_coord_host = Kokkos::create_mirror_view( new_points_coord );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        for ( unsigned int d = 0; d < dim; ++d )
+        {
+            double shift;
+            if ( i == 0 )
+                shift = 0.1;
+            else if ( i == 1 )
+                shift = ( d == 0 ) ? 1. : 0.;
+            else
+                shift = 0.05 * ( d + 2 );
+            new_points_coord_host( i, d ) = points_coord_host( i, d ) + shift;
+        }
+    Kokkos::deep_copy( new_points_coord, new_points_coord_host );
+
+    interpolation.update( new_points_coord );
+    DataTransferKit::Interpolation<DeviceType> new_interpolation(
+        comm, mesh, new_points_coord, cell_dofs_ids, DTK_HGRAD );
+
+    Kokkos::View<double **, DeviceType> Y_ref( "Y_ref", n_points, n_fields );
+    auto query_ids = interpolation.apply( X, Y );
+    auto ref_query_ids = new_interpolation.apply( X, Y_ref );
+    auto query_ids_host = Kokkos::create_mirror_view( query_ids );
+    Kokkos::deep_copy( query_ids_host, query_ids );
+    auto ref_query_ids_host = Kokkos::create_mirror_view( ref_query_ids );
+    Kokkos::deep_copy( ref_query_ids_host, ref_query_ids );
+    TEST_COMPARE_ARRAYS( query_ids_host, ref_query_ids_host );
+
+    Kokkos::View<double **, DeviceType> gradient_Y( "gradient_Y", n_points,
+                                                    n_fields );
+    Kokkos::View<double ***, DeviceType> grad_Y_ref( "grad_Y_ref", n_points,
+                                                     n_fields, dim );
+    interpolation.apply( X, gradient_Y, grad_Y );
+    new_interpolation.apply( X, gradient_Y, grad_Y_ref );
+    Kokkos::View<float **, DeviceType> float_Y_ref( "float_Y_ref", n_points,
+                                                    n_fields );
+    interpolation.apply( float_X, float_Y );
+    new_interpolation.apply( float_X, float_Y_ref );
+
+    auto Y_host = Kokkos::create_mirror_view( Y );
+    Kokkos::deep_copy( Y_host, Y );
+    auto Y_ref_host = Kokkos::create_mirror_view( Y_ref );
+    Kokkos::deep_copy( Y_ref_host, Y_ref );
+    auto grad_Y_host = Kokkos::create_mirror_view( grad_Y );
+    Kokkos::deep_copy( grad_Y_host, grad_Y );
+    auto grad_Y_ref_host = Kokkos::create_mirror_view( grad_Y_ref );
+    Kokkos::deep_copy( grad_Y_ref_host, grad_Y_ref );
+    auto float_Y_host = Kokkos::create_mirror_view( float_Y );
+    Kokkos::deep_copy( float_Y_host, float_Y );
+    auto float_Y_ref_host = Kokkos::create_mirror_view( float_Y_ref );
+    Kokkos::deep_copy( float_Y_ref_host, float_Y_ref );
+    for ( unsigned int i = 0; i < n_points; ++i )
+    {
+        if ( ref_query_ids_host( i ) == -1 )
+            continue;
+        for ( unsigned int j = 0; j < n_fields; ++j )
+        {
+            TEST_FLOATING_EQUALITY( Y_host( i, j ), Y_ref_host( i, j ),
+                                    1e-14 );
+            TEST_FLOATING_EQUALITY(
+                static_cast<double>( float_Y_host( i, j ) ),
+                static_cast<double>( float_Y_ref_host( i, j ) ), 1e-6 );
+            for ( unsigned int d = 0; d < dim; ++d )
+                TEST_ASSERT( std::abs( grad_Y_host( i, j, d ) -
+                                       grad_Y_ref_host( i, j, d ) ) < 1e-12 );
+        }
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation, fe_cardinality, DeviceType )
+{
+    // The number of degrees of freedom per cell must be the cardinality of
+    // the Intrepid2 basis of each finite element.
+    using namespace DataTransferKit;
+    using ExecutionSpace = typename DeviceType::execution_space;
+    TEST_EQUALITY( getCardinality( FE::HEX_HCURL_1 ),
+                   ( getBasisCardinality<HEX_HCURL_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::HEX_HDIV_1 ),
+                   ( getBasisCardinality<HEX_HDIV_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::HEX_HGRAD_1 ),
+                   ( getBasisCardinality<HEX_HGRAD_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::HEX_HGRAD_2 ),
+                   ( getBasisCardinality<HEX_HGRAD_2, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::PYR_HGRAD_1 ),
+                   ( getBasisCardinality<PYR_HGRAD_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::QUAD_HCURL_1 ),
+                   ( getBasisCardinality<QUAD_HCURL_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::QUAD_HDIV_1 ),
+                   ( getBasisCardinality<QUAD_HDIV_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::QUAD_HGRAD_1 ),
+                   ( getBasisCardinality<QUAD_HGRAD_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::QUAD_HGRAD_2 ),
+                   ( getBasisCardinality<QUAD_HGRAD_2, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::TET_HCURL_1 ),
+                   ( getBasisCardinality<TET_HCURL_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::TET_HDIV_1 ),
+                   ( getBasisCardinality<TET_HDIV_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::TET_HGRAD_1 ),
+                   ( getBasisCardinality<TET_HGRAD_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::TET_HGRAD_2 ),
+                   ( getBasisCardinality<TET_HGRAD_2, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::TRI_HGRAD_1 ),
+                   ( getBasisCardinality<TRI_HGRAD_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::TRI_HGRAD_2 ),
+                   ( getBasisCardinality<TRI_HGRAD_2, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::WEDGE_HGRAD_1 ),
+                   ( getBasisCardinality<WEDGE_HGRAD_1, ExecutionSpace>() ) );
+    TEST_EQUALITY( getCardinality( FE::WEDGE_HGRAD_2 ),
+                   ( getBasisCardinality<WEDGE_HGRAD_2, ExecutionSpace>() ) );
+
+    // A tetrahedron has six edges.
+    TEST_EQUALITY( getCardinality( FE::TET_HCURL_1 ), 6u );
+}
+
 // Include the test macros.
 #include "DataTransferKit_ETIHelperMacros.h"
 
@@ -524,13 +967,24 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( Interpolation,
     using DeviceType##NODE = typename NODE::device_type;                       \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
         Interpolation, one_topo_one_fe_three_dim, DeviceType##NODE )           \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
+        Interpolation, one_topo_one_fe_three_dim_many_fields,                  \
+        DeviceType##NODE )                                                     \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
+        Interpolation, one_topo_one_fe_gradient, DeviceType##NODE )            \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
+        Interpolation, one_topo_one_fe_transpose, DeviceType##NODE )           \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( Interpolation, two_topo_two_dim,     \
                                           DeviceType##NODE )                   \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
         Interpolation, one_topo_one_fe_three_dim_hdiv, DeviceType##NODE )      \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
         Interpolation, one_topo_one_fe_three_dim_point_not_found,              \
-        DeviceType##NODE )
+        DeviceType##NODE )                                                     \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( Interpolation, update,               \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( Interpolation, fe_cardinality,       \
+                                          DeviceType##NODE )
 
 // Demangle the types
 DTK_ETI_MANGLING_TYPEDEFS()
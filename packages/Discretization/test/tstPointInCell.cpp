@@ -16,9 +16,11 @@
 
 #include <array>
 
-// We only test DTK_HEX_8 and DTK_QUAD_4. Testing all the topologies would
-// require a lot of code (need to create a bunch of meshes) and the only
-// difference in the search is the template parameters in the Functor.
+// We only test DTK_HEX_8, DTK_QUAD_4, and DTK_TET_4. Testing all the
+// topologies would require a lot of code (need to create a bunch of meshes)
+// and the only difference in the search is the template parameters in the
+// Functor. The parallelepipeds and the tetrahedra use the closed-form map to
+// the reference frame, the trapezoid uses the Newton solver.
 
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointInCell, hex_8, DeviceType )
 {
@@ -243,6 +245,126 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointInCell, quad_4, DeviceType )
     }
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointInCell, tet_4, DeviceType )
+{
+    unsigned int constexpr dim = 3;
+    DTK_CellTopology cell_topology = DTK_TET_4;
+    unsigned int constexpr n_ref_pts = 2;
+
+    Kokkos::View<double * [dim], DeviceType> reference_points( "ref_pts",
+                                                               n_ref_pts );
+    Kokkos::View<bool *, DeviceType> point_in_cell( "pt_in_cell", n_ref_pts );
+    // Physical points are (1.5, 1.5, 1.5) and (3., 3., 1.)
+    Kokkos::View<double * [dim], DeviceType> physical_points( "phys_pts",
+                                                              n_ref_pts );
+    physical_points( 0, 0 ) = 1.5;
+    physical_points( 0, 1 ) = 1.5;
+    physical_points( 0, 2 ) = 1.5;
+    physical_points( 1, 0 ) = 3.;
+    physical_points( 1, 1 ) = 3.;
+    physical_points( 1, 2 ) = 1.;
+    // Vertices of the cell
+    Kokkos::View<double * * [dim], DeviceType> cells( "cell_nodes", 1, 4 );
+    cells( 0, 0, 0 ) = 1.;
+    cells( 0, 0, 1 ) = 1.;
+    cells( 0, 0, 2 ) = 1.;
+    cells( 0, 1, 0 ) = 3.;
+    cells( 0, 1, 1 ) = 1.;
+    cells( 0, 1, 2 ) = 1.;
+    cells( 0, 2, 0 ) = 1.;
+    cells( 0, 2, 1 ) = 3.;
+    cells( 0, 2, 2 ) = 1.;
+    cells( 0, 3, 0 ) = 1.;
+    cells( 0, 3, 1 ) = 1.;
+    cells( 0, 3, 2 ) = 3.;
+    // Coarse search output: cells
+    Kokkos::View<int *, DeviceType> coarse_srch_cells( "coarse_srch_cells",
+                                                       n_ref_pts );
+    coarse_srch_cells( 0 ) = 0;
+    coarse_srch_cells( 1 ) = 0;
+
+    DataTransferKit::PointInCell<DeviceType>::search(
+        physical_points, cells, coarse_srch_cells, cell_topology,
+        reference_points, point_in_cell );
+
+    auto reference_points_host = Kokkos::create_mirror_view( reference_points );
+    Kokkos::deep_copy( reference_points_host, reference_points );
+    auto point_in_cell_host = Kokkos::create_mirror_view( point_in_cell );
+    Kokkos::deep_copy( point_in_cell_host, point_in_cell );
+
+    std::vector<std::array<double, dim>> reference_points_ref = {
+        {{0.25, 0.25, 0.25}}, {{1., 1., 0.}}};
+    std::vector<bool> point_in_cell_ref = {true, false};
+
+    double const tol = 1e-14;
+    for ( unsigned int i = 0; i < n_ref_pts; ++i )
+    {
+        for ( unsigned int j = 0; j < dim; ++j )
+            TEST_ASSERT( std::abs( reference_points_host( i, j ) -
+                                   reference_points_ref[i][j] ) < tol );
+        TEST_EQUALITY( point_in_cell_host( i ), point_in_cell_ref[i] );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointInCell, quad_4_trapezoid, DeviceType )
+{
+    unsigned int constexpr dim = 2;
+    DTK_CellTopology cell_topology = DTK_QUAD_4;
+    unsigned int constexpr n_ref_pts = 3;
+
+    Kokkos::View<double * [dim], DeviceType> reference_points( "ref_pts",
+                                                               n_ref_pts );
+    Kokkos::View<bool *, DeviceType> point_in_cell( "pt_in_cell", n_ref_pts );
+    // Physical points are (1., 0.5), (1.3125, 0.75), and (2., 1.)
+    Kokkos::View<double * [dim], DeviceType> physical_points( "phys_pts",
+                                                              n_ref_pts );
+    physical_points( 0, 0 ) = 1.;
+    physical_points( 0, 1 ) = 0.5;
+    physical_points( 1, 0 ) = 1.3125;
+    physical_points( 1, 1 ) = 0.75;
+    physical_points( 2, 0 ) = 2.;
+    physical_points( 2, 1 ) = 1.;
+    // Vertices of the cell. The cell is not a parallelogram.
+    Kokkos::View<double * * [dim], DeviceType> cells( "cell_nodes", 1, 4 );
+    cells( 0, 0, 0 ) = 0.;
+    cells( 0, 0, 1 ) = 0.;
+    cells( 0, 1, 0 ) = 2.;
+    cells( 0, 1, 1 ) = 0.;
+    cells( 0, 2, 0 ) = 1.5;
+    cells( 0, 2, 1 ) = 1.;
+    cells( 0, 3, 0 ) = 0.5;
+    cells( 0, 3, 1 ) = 1.;
+    // Coarse search output: cells
+    Kokkos::View<int *, DeviceType> coarse_srch_cells( "coarse_srch_cells",
+                                                       n_ref_pts );
+    coarse_srch_cells( 0 ) = 0;
+    coarse_srch_cells( 1 ) = 0;
+    coarse_srch_cells( 2 ) = 0;
+
+    DataTransferKit::PointInCell<DeviceType>::search(
+        physical_points, cells, coarse_srch_cells, cell_topology,
+        reference_points, point_in_cell );
+
+    auto reference_points_host = Kokkos::create_mirror_view( reference_points );
+    Kokkos::deep_copy( reference_points_host, reference_points );
+    auto point_in_cell_host = Kokkos::create_mirror_view( point_in_cell );
+    Kokkos::deep_copy( point_in_cell_host, point_in_cell );
+
+    std::vector<std::array<double, dim>> reference_points_ref = {
+        {{0., 0.}}, {{0.5, 0.5}}};
+    std::vector<bool> point_in_cell_ref = {true, true, false};
+
+    double const tol = 1e-10;
+    for ( unsigned int i = 0; i < n_ref_pts; ++i )
+    {
+        if ( i < reference_points_ref.size() )
+            for ( unsigned int j = 0; j < dim; ++j )
+                TEST_ASSERT( std::abs( reference_points_host( i, j ) -
+                                       reference_points_ref[i][j] ) < tol );
+        TEST_EQUALITY( point_in_cell_host( i ), point_in_cell_ref[i] );
+    }
+}
+
 // Include the test macros.
 #include "DataTransferKit_ETIHelperMacros.h"
 
@@ -253,6 +375,10 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointInCell, quad_4, DeviceType )
                                           DeviceType##NODE )                   \
     using DeviceType##NODE = typename NODE::device_type;                       \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PointInCell, quad_4,                 \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PointInCell, tet_4,                  \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PointInCell, quad_4_trapezoid,       \
                                           DeviceType##NODE )
 
 // Demangle the types
@@ -154,6 +154,64 @@ void checkReferencePoints(
     }
 }
 
+template <typename DeviceType>
+void checkSameResults(
+    DataTransferKit::PointSearch<DeviceType> const &ref_search,
+    DataTransferKit::PointSearch<DeviceType> const &pt_search, bool &success,
+    Teuchos::FancyOStream &out )
+{
+    unsigned int constexpr dim = 3;
+    Kokkos::View<int *, DeviceType> ref_ranks;
+    Kokkos::View<int *, DeviceType> ref_cell_indices;
+    Kokkos::View<ArborX::Point *, DeviceType> ref_reference_points;
+    Kokkos::View<unsigned int *, DeviceType> ref_query_ids;
+    std::tie( ref_ranks, ref_cell_indices, ref_reference_points,
+              ref_query_ids ) = ref_search.getSearchResults();
+
+    Kokkos::View<int *, DeviceType> ranks;
+    Kokkos::View<int *, DeviceType> cell_indices;
+    Kokkos::View<ArborX::Point *, DeviceType> reference_points;
+    Kokkos::View<unsigned int *, DeviceType> query_ids;
+    std::tie( ranks, cell_indices, reference_points, query_ids ) =
+        pt_search.getSearchResults();
+
+    unsigned int const n_results = ref_ranks.extent( 0 );
+    TEST_EQUALITY( ranks.extent( 0 ), n_results );
+    TEST_EQUALITY( cell_indices.extent( 0 ), n_results );
+    TEST_EQUALITY( reference_points.extent( 0 ), n_results );
+    TEST_EQUALITY( query_ids.extent( 0 ), n_results );
+
+    auto ref_ranks_host = Kokkos::create_mirror_view( ref_ranks );
+    Kokkos::deep_copy( ref_ranks_host, ref_ranks );
+    auto ref_cell_indices_host = Kokkos::create_mirror_view( ref_cell_indices );
+    Kokkos::deep_copy( ref_cell_indices_host, ref_cell_indices );
+    auto ref_reference_points_host =
+        Kokkos::create_mirror_view( ref_reference_points );
+    Kokkos::deep_copy( ref_reference_points_host, ref_reference_points );
+    auto ref_query_ids_host = Kokkos::create_mirror_view( ref_query_ids );
+    Kokkos::deep_copy( ref_query_ids_host, ref_query_ids );
+    auto ranks_host = Kokkos::create_mirror_view( ranks );
+    Kokkos::deep_copy( ranks_host, ranks );
+    auto cell_indices_host = Kokkos::create_mirror_view( cell_indices );
+    Kokkos::deep_copy( cell_indices_host, cell_indices );
+    auto reference_points_host = Kokkos::create_mirror_view( reference_points );
+    Kokkos::deep_copy( reference_points_host, reference_points );
+    auto query_ids_host = Kokkos::create_mirror_view( query_ids );
+    Kokkos::deep_copy( query_ids_host, query_ids );
+
+    double const tol = 1e-14;
+    for ( unsigned int i = 0; i < n_results; ++i )
+    {
+        TEST_EQUALITY( ranks_host( i ), ref_ranks_host( i ) );
+        TEST_EQUALITY( cell_indices_host( i ), ref_cell_indices_host( i ) );
+        TEST_EQUALITY( query_ids_host( i ), ref_query_ids_host( i ) );
+        for ( unsigned int d = 0; d < dim; ++d )
+            TEST_FLOATING_EQUALITY( reference_points_host( i )[d],
+                                    ref_reference_points_host( i )[d],
+                                    tol );
+    }
+}
+
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch, one_topo_three_dim, DeviceType )
 {
     MPI_Comm comm = MPI_COMM_WORLD;
@@ -183,14 +241,15 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch, one_topo_three_dim, DeviceType )
     std::tie( ranks, cell_indices, reference_points, query_ids ) =
         pt_search.getSearchResults();
 
-    // Check the number of points found on each processor
+    // Check the number of points found on each processor. The points shared
+    // by several cells are only found once.
     if ( comm_rank == 0 )
     {
-        TEST_EQUALITY( reference_points.extent( 0 ), 16 );
+        TEST_EQUALITY( reference_points.extent( 0 ), 5 );
     }
     else if ( comm_rank == 1 )
     {
-        TEST_EQUALITY( reference_points.extent( 0 ), 16 );
+        TEST_EQUALITY( reference_points.extent( 0 ), 5 );
     }
     else
     {
@@ -357,6 +416,115 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch,
     TEST_EQUALITY( query_ids.extent( 0 ), 0 );
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch, reuse_mesh_index, DeviceType )
+{
+    MPI_Comm comm = MPI_COMM_WORLD;
+    unsigned int constexpr dim = 3;
+    Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies_view;
+    Kokkos::View<unsigned int *, DeviceType> cells;
+    Kokkos::View<double **, DeviceType> coordinates;
+    std::vector<unsigned int> n_subdivisions = {{5, 5, 3}};
+    std::tie( cell_topologies_view, cells, coordinates ) =
+        buildStructuredMesh<DeviceType>( comm, n_subdivisions );
+    Kokkos::View<double * [dim], DeviceType> points_coord =
+        getPointsCoord3D<DeviceType>( comm );
+
+    DataTransferKit::Mesh<DeviceType> mesh( cell_topologies_view, cells,
+                                            coordinates );
+    DataTransferKit::PointSearch<DeviceType> ref_search( comm, mesh,
+                                                         points_coord );
+
+    // Build the index once and use it for two searches
+    DataTransferKit::MeshSearchIndex<DeviceType> mesh_index( comm, mesh );
+    TEST_EQUALITY( mesh_index.getDimension(), dim );
+    for ( int search = 0; search < 2; ++search )
+    {
+        DataTransferKit::PointSearch<DeviceType> pt_search( mesh_index,
+                                                            points_coord );
+
+        checkSameResults( ref_search, pt_search, success, out );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch, update, DeviceType )
+{
+    MPI_Comm comm = MPI_COMM_WORLD;
+    unsigned int constexpr dim = 3;
+    Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies_view;
+    Kokkos::View<unsigned int *, DeviceType> cells;
+    Kokkos::View<double **, DeviceType> coordinates;
+    std::vector<unsigned int> n_subdivisions = {{5, 5, 3}};
+    std::tie( cell_topologies_view, cells, coordinates ) =
+        buildStructuredMesh<DeviceType>( comm, n_subdivisions );
+    Kokkos::View<double * [dim], DeviceType> points_coord =
+        getPointsCoord3D<DeviceType>( comm );
+
+    DataTransferKit::MeshSearchIndex<DeviceType> mesh_index(
+        comm, DataTransferKit::Mesh<DeviceType>( cell_topologies_view, cells,
+                                                 coordinates ) );
+    DataTransferKit::PointSearch<DeviceType> ref_search( mesh_index,
+                                                         points_coord );
+
+    // Start with points outside of the mesh so that all the points are
+    // searched again during the first update
+    unsigned int const n_points = points_coord.extent( 0 );
+    Kokkos::View<double * [dim], DeviceType> far_points_coord(
+        "far_points_coord", n_points );
+    Kokkos::deep_copy( far_points_coord, 10000. );
+    DataTransferKit::PointSearch<DeviceType> pt_search( mesh_index,
+                                                        far_points_coord );
+    pt_search.update( points_coord );
+    checkSameResults( ref_search, pt_search, success, out );
+
+    // The points do not move so all of them stay in their cells
+    pt_search.update( points_coord );
+    checkSameResults( ref_search, pt_search, success, out );
+
+    // Move the points out of the mesh
+    pt_search.update( far_points_coord );
+    Kokkos::View<int *, DeviceType> ranks;
+    Kokkos::View<int *, DeviceType> cell_indices;
+    Kokkos::View<ArborX::Point *, DeviceType> reference_points;
+    Kokkos::View<unsigned int *, DeviceType> query_ids;
+    std::tie( ranks, cell_indices, reference_points, query_ids ) =
+        pt_search.getSearchResults();
+    TEST_EQUALITY( ranks.extent( 0 ), 0 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch, morton_ordering, DeviceType )
+{
+    MPI_Comm comm = MPI_COMM_WORLD;
+    unsigned int constexpr dim = 3;
+    Kokkos::View<DTK_CellTopology *, DeviceType> cell_topologies_view;
+    Kokkos::View<unsigned int *, DeviceType> cells;
+    Kokkos::View<double **, DeviceType> coordinates;
+    std::vector<unsigned int> n_subdivisions = {{5, 5, 3}};
+    std::tie( cell_topologies_view, cells, coordinates ) =
+        buildStructuredMesh<DeviceType>( comm, n_subdivisions );
+    Kokkos::View<double * [dim], DeviceType> points_coord =
+        getPointsCoord3D<DeviceType>( comm );
+
+    DataTransferKit::MeshSearchIndex<DeviceType> mesh_index(
+        comm, DataTransferKit::Mesh<DeviceType>( cell_topologies_view, cells,
+                                                 coordinates ) );
+    DataTransferKit::PointSearch<DeviceType> ref_search( mesh_index,
+                                                         points_coord );
+
+    // Searching for the points along the Morton curve does not change the
+    // results, including after an update.
+    DataTransferKit::PointSearch<DeviceType> pt_search(
+        mesh_index, points_coord, DataTransferKit::PointOrdering::Morton );
+    checkSameResults( ref_search, pt_search, success, out );
+
+    unsigned int const n_points = points_coord.extent( 0 );
+    Kokkos::View<double * [dim], DeviceType> far_points_coord(
+        "far_points_coord", n_points );
+    Kokkos::deep_copy( far_points_coord, 10000. );
+    pt_search.update( far_points_coord );
+    pt_search.update( points_coord );
+    checkSameResults( ref_search, pt_search, success, out );
+}
+
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch, two_topo_two_dim, DeviceType )
 {
     // Test a mesh of made of Quadrilateral<4> and Triangle<3>
@@ -397,8 +565,9 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch, two_topo_two_dim, DeviceType )
     std::tie( ranks, cell_indices, reference_points, query_ids ) =
         pt_search.getSearchResults();
 
-    // Check the number of points found on each processor
-    TEST_EQUALITY( reference_points.extent( 0 ), 9 );
+    // Check the number of points found on each processor. The points shared
+    // by several cells are only found once.
+    TEST_EQUALITY( reference_points.extent( 0 ), 4 );
 
     // Reference solution
     typedef std::array<double, dim> PtCoord;
@@ -453,6 +622,12 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PointSearch, two_topo_two_dim, DeviceType )
                                           DeviceType##NODE )                   \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
         PointSearch, one_topo_three_dim_no_point_found, DeviceType##NODE )     \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PointSearch, reuse_mesh_index,       \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PointSearch, update,                 \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PointSearch, morton_ordering,        \
+                                          DeviceType##NODE )                   \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PointSearch, two_topo_two_dim,       \
                                           DeviceType##NODE )
 
@@ -29,6 +29,8 @@
 
 #include <mpi.h>
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -80,15 +82,45 @@ struct DTK_MapImpl : public DTK_Map
             target_nodes.extent( 1 ) );
         Kokkos::deep_copy( target_nodes_copy, target_nodes );
 
+        // The operators work with the points of the user applications
+        // without padding them to three dimensions.
+        int const space_dim = source_nodes.extent( 1 );
+        if ( target_nodes.extent_int( 1 ) != space_dim )
+            throw DataTransferKitException(
+                "Source and target nodes have different dimensions" );
+        if ( space_dim == 2 )
+            _map = createOperator<2>( comm, source_nodes_copy,
+                                      target_nodes_copy, ptree );
+        else if ( space_dim == 3 )
+            _map = createOperator<3>( comm, source_nodes_copy,
+                                      target_nodes_copy, ptree );
+        else
+            throw DataTransferKitException(
+                "Invalid dimension " + std::to_string( space_dim ) +
+                " for creating a map" );
+    }
+
+    template <int DIM>
+    static std::unique_ptr<PointCloudOperator<map_device_type>>
+    createOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, map_device_type> source_nodes,
+        Kokkos::View<Coordinate const **, map_device_type> target_nodes,
+        boost::property_tree::ptree const &ptree )
+    {
+        using OperatorPointer =
+            std::unique_ptr<PointCloudOperator<map_device_type>>;
         auto const which_map =
             ptree.get<std::string>( "Map Type", "Undefined" );
+        auto const ordering = getPointOrdering( ptree );
+        auto const precision = getCoefficientPrecision( ptree );
         if ( which_map == "Undefined" )
             throw DataTransferKitException(
                 R"(Field "Map Type" is not defined in options string argument for map creation)" );
         else if ( which_map == "Nearest Neighbor" || which_map == "NN" )
-            _map = std::unique_ptr<NearestNeighborOperator<map_device_type>>(
-                new NearestNeighborOperator<map_device_type>(
-                    comm, source_nodes_copy, target_nodes_copy ) );
+            return OperatorPointer(
+                new NearestNeighborOperator<map_device_type, DIM>(
+                    comm, source_nodes, target_nodes, ordering ) );
         else if ( which_map == "Moving Least Squares" || which_map == "MLS" )
         {
             // NOTE if field "Order" is misspelled (for instance first letter
@@ -96,21 +128,24 @@ struct DTK_MapImpl : public DTK_Map
             // picked up without a warning or an error being raised.
             auto const order = ptree.get<std::string>( "Order", "Linear" );
             if ( order == "Linear" || order == "1" )
-                _map = std::unique_ptr<MovingLeastSquaresOperator<
-                    map_device_type, Wendland<0>,
-                    MultivariatePolynomialBasis<Linear, 3>>>(
+                return OperatorPointer(
                     new MovingLeastSquaresOperator<
                         map_device_type, Wendland<0>,
-                        MultivariatePolynomialBasis<Linear, 3>>(
-                        comm, source_nodes_copy, target_nodes_copy ) );
+                        MultivariatePolynomialBasis<Linear, DIM>>(
+                        comm, source_nodes, target_nodes,
+                        getNumberOfNeighbors<
+                            MultivariatePolynomialBasis<Linear, DIM>>( ptree ),
+                        ordering, precision ) );
             else if ( order == "Quadratic" || order == "2" )
-                _map = std::unique_ptr<MovingLeastSquaresOperator<
-                    map_device_type, Wendland<0>,
-                    MultivariatePolynomialBasis<Quadratic, 3>>>(
+                return OperatorPointer(
                     new MovingLeastSquaresOperator<
                         map_device_type, Wendland<0>,
-                        MultivariatePolynomialBasis<Quadratic, 3>>(
-                        comm, source_nodes_copy, target_nodes_copy ) );
+                        MultivariatePolynomialBasis<Quadratic, DIM>>(
+                        comm, source_nodes, target_nodes,
+                        getNumberOfNeighbors<
+                            MultivariatePolynomialBasis<Quadratic, DIM>>(
+                            ptree ),
+                        ordering, precision ) );
             else
                 throw DataTransferKitException(
                     "Invalid order \"" + order +
@@ -121,6 +156,68 @@ struct DTK_MapImpl : public DTK_Map
                                             "\"" );
     }
 
+    // Number of neighbors of the moving least squares map. It is given either
+    // directly by "Number of Neighbors" or as a multiple of the size of the
+    // polynomial basis by "Oversampling Factor". Without any of them, the
+    // size of the basis is used.
+    template <typename PolynomialBasis>
+    static unsigned int
+    getNumberOfNeighbors( boost::property_tree::ptree const &ptree )
+    {
+        auto const basis_size = PolynomialBasis::size;
+        if ( ptree.count( "Number of Neighbors" ) > 0 &&
+             ptree.count( "Oversampling Factor" ) > 0 )
+            throw DataTransferKitException(
+                R"(Fields "Number of Neighbors" and "Oversampling Factor" are mutually exclusive)" );
+        auto const n_neighbors =
+            ptree.get<int>( "Number of Neighbors", basis_size );
+        if ( n_neighbors < basis_size )
+            throw DataTransferKitException(
+                "Number of neighbors " + std::to_string( n_neighbors ) +
+                " is smaller than the size of the polynomial basis " +
+                std::to_string( basis_size ) );
+        auto const oversampling_factor =
+            ptree.get<double>( "Oversampling Factor", 1. );
+        if ( !( oversampling_factor >= 1. ) )
+            throw DataTransferKitException(
+                "Oversampling factor " + std::to_string( oversampling_factor ) +
+                " is smaller than one" );
+        return std::max<int>( n_neighbors,
+                              std::ceil( oversampling_factor * basis_size ) );
+    }
+
+    // Order in which the operators search for the neighbors of the target
+    // points. The results do not depend on it.
+    static PointOrdering
+    getPointOrdering( boost::property_tree::ptree const &ptree )
+    {
+        auto const ordering =
+            ptree.get<std::string>( "Point Ordering", "Caller" );
+        if ( ordering == "Caller" )
+            return PointOrdering::Caller;
+        else if ( ordering == "Morton" )
+            return PointOrdering::Morton;
+        else
+            throw DataTransferKitException( "Invalid point ordering \"" +
+                                            ordering + "\"" );
+    }
+
+    // Precision in which the moving least squares map stores its
+    // coefficients.
+    static CoefficientPrecision
+    getCoefficientPrecision( boost::property_tree::ptree const &ptree )
+    {
+        auto const precision =
+            ptree.get<std::string>( "Coefficient Precision", "Double" );
+        if ( precision == "Double" )
+            return CoefficientPrecision::Double;
+        else if ( precision == "Single" )
+            return CoefficientPrecision::Single;
+        else
+            throw DataTransferKitException( "Invalid coefficient precision \"" +
+                                            precision + "\"" );
+    }
+
     void apply( const std::string &source_field_name,
                 const std::string &target_field_name ) override
     {
@@ -131,24 +228,23 @@ struct DTK_MapImpl : public DTK_Map
         // Pull the data from the source.
         _source.pullField( source_field_name, source_field );
 
-        // Copy to a compatible layout. Nearest neighbor operator needs a
-        // compatible layout and only 1 dimension
+        // Copy to a compatible layout. All the components of the field are
+        // transferred at once.
         int num_src = source_field.dofs.extent( 0 );
-        Kokkos::View<double *, map_device_type> source_field_copy(
-            "source_field_copy", num_src );
-        Kokkos::deep_copy(
-            source_field_copy,
-            Kokkos::subview( source_field.dofs, Kokkos::ALL, 0 ) );
+        int num_components = source_field.dofs.extent( 1 );
+        DTK_INSIST( target_field.dofs.extent_int( 1 ) == num_components );
+        Kokkos::View<double **, map_device_type> source_field_copy(
+            "source_field_copy", num_src, num_components );
+        Kokkos::deep_copy( source_field_copy, source_field.dofs );
         int num_tgt = target_field.dofs.extent( 0 );
-        Kokkos::View<double *, map_device_type> target_field_copy(
-            "target_field_copy", num_tgt );
+        Kokkos::View<double **, map_device_type> target_field_copy(
+            "target_field_copy", num_tgt, num_components );
 
         // Apply the map.
         _map->apply( source_field_copy, target_field_copy );
 
         // Copy the transferred field back to the original target layout.
-        Kokkos::deep_copy( Kokkos::subview( target_field.dofs, Kokkos::ALL, 0 ),
-                           target_field_copy );
+        Kokkos::deep_copy( target_field.dofs, target_field_copy );
 
         // Push the data to the target.
         _target.pushField( target_field_name, target_field );
@@ -226,6 +226,13 @@ void test( bool &success, Teuchos::FancyOStream &out )
                                                       // double quoted
               R"({ "Map Type": "MLS", "Order": "Quadratic" })",
               R"({ "Map Type": "MLS", "Order": "2" })",
+              R"({ "Map Type": "MLS", "Number of Neighbors": 8 })",
+              R"({ "Map Type": "MLS", "Order": 2, "Number of Neighbors": 20 })",
+              R"({ "Map Type": "MLS", "Oversampling Factor": 1.5 })",
+              R"({ "Map Type": "NN", "Point Ordering": "Morton" })",
+              R"({ "Map Type": "MLS", "Point Ordering": "Morton" })",
+              R"({ "Map Type": "MLS", "Point Ordering": "Caller" })",
+              R"({ "Map Type": "MLS", "Coefficient Precision": "Single" })",
           } )
     {
         auto map_handle =
@@ -259,6 +266,12 @@ void test( bool &success, Teuchos::FancyOStream &out )
             R"({ "Map Type": "Is Not Defined Anywhere" })", // invalid value
             R"({ "Map Type": "MLS", "Order": 3 })", // order 3 not available
             R"({ "Map Type": "MLS", "Order": "Invalid" })",
+            R"({ "Map Type": "MLS", "Number of Neighbors": 3 })", // fewer than
+                                                                  // the basis
+            R"({ "Map Type": "MLS", "Oversampling Factor": 0.5 })",
+            R"({ "Map Type": "MLS", "Number of Neighbors": 8, "Oversampling Factor": 2 })",
+            R"({ "Map Type": "NN", "Point Ordering": "Hilbert" })",
+            R"({ "Map Type": "MLS", "Coefficient Precision": "Half" })",
         } )
     {
         TEST_THROW( DTK_createMap( SpaceSelector<MapSpace>::value(), comm,
@@ -0,0 +1,71 @@
+/****************************************************************************
+ * Copyright (c) 2012-2019 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_CRS_MATRIX_HPP
+#define DTK_CRS_MATRIX_HPP
+
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+
+#include <Kokkos_Core.hpp>
+
+namespace DataTransferKit
+{
+
+// Sparse matrix in compressed row storage. row_map, entries, and values follow
+// the KokkosSparse::CrsMatrix conventions so that they can be used to build a
+// KokkosSparse or a Tpetra matrix without copy.
+//
+// The rows are the local target points. The columns are the distinct source
+// points used by this process, sorted by rank and then by local index: column
+// j is the source point of local index column_indices(j) on the process
+// column_ranks(j). A source point used by several rows is a single column, so
+// that its value is imported once.
+template <typename DeviceType>
+struct CrsMatrix
+{
+    Kokkos::View<int *, DeviceType> row_map;
+    Kokkos::View<int *, DeviceType> entries;
+    Kokkos::View<double *, DeviceType> values;
+    Kokkos::View<int *, DeviceType> column_ranks;
+    Kokkos::View<int *, DeviceType> column_indices;
+};
+
+// Sparse matrix-vector product y = A x.
+template <typename DeviceType>
+void multiply( CrsMatrix<DeviceType> const &a,
+               Kokkos::View<double const *, DeviceType> x,
+               Kokkos::View<double *, DeviceType> y )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    auto const n_rows = a.row_map.extent_int( 0 ) - 1;
+    DTK_REQUIRE( y.extent_int( 0 ) == n_rows );
+    DTK_REQUIRE( x.extent( 0 ) == a.column_ranks.extent( 0 ) );
+
+    auto const row_map = a.row_map;
+    auto const entries = a.entries;
+    auto const values = a.values;
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "spmv" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_rows ),
+        KOKKOS_LAMBDA( int const i ) {
+            double tmp = 0.;
+            for ( int j = row_map( i ); j < row_map( i + 1 ); ++j )
+                tmp += values( j ) * x( entries( j ) );
+            y( i ) = tmp;
+        } );
+    Kokkos::fence();
+}
+
+} // end namespace DataTransferKit
+
+#endif
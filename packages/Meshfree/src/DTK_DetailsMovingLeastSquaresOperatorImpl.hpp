@@ -15,7 +15,10 @@
 #include <ArborX.hpp>
 #include <ArborX_DetailsKokkosExt.hpp> // ArithmeticTraits
 #include <DTK_CompactlySupportedRadialBasisFunctions.hpp>
-#include <DTK_DetailsSVDImpl.hpp>
+#include <DTK_DetailsNearestNeighborOperatorImpl.hpp> // embedPoint
+#include <DTK_DetailsSymmetricSolverImpl.hpp>
+
+#include <mpi.h>
 
 namespace DataTransferKit
 {
@@ -38,281 +41,550 @@ struct MovingLeastSquaresOperatorImpl
             DTK_MARK_REGION( "setup_queries" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
             KOKKOS_LAMBDA( int i ) {
-                queries( i ) = nearest(
-                    ArborX::Point{{target_points( i, 0 ), target_points( i, 1 ),
-                                   target_points( i, 2 )}},
-                    n_neighbors );
+                queries( i ) =
+                    nearest( embedPoint( target_points, i ), n_neighbors );
             } );
         Kokkos::fence();
         return queries;
     }
 
-    static Kokkos::View<double *, DeviceType> computeTargetValues(
-        Kokkos::View<int const *, DeviceType> offset,
-        Kokkos::View<double const *, DeviceType> polynomial_coeffs,
-        Kokkos::View<double const *, DeviceType> source_values )
+    static Kokkos::View<decltype( ArborX::intersects( ArborX::Sphere{} ) ) *,
+                        DeviceType>
+    makeRadiusQueries(
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        Kokkos::View<double const *, DeviceType> radius )
     {
-        auto const n_target_points = offset.extent_int( 0 ) - 1;
-        Kokkos::View<double *, DeviceType> target_values(
-            std::string( "target_" ) + source_values.label(), n_target_points );
-
+        DTK_REQUIRE( radius.extent( 0 ) == target_points.extent( 0 ) );
+        auto const n_points = target_points.extent( 0 );
+        Kokkos::View<decltype( ArborX::intersects( ArborX::Sphere{} ) ) *,
+                     DeviceType>
+            queries( "queries", n_points );
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_values" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
-            KOKKOS_LAMBDA( const int i ) {
-                target_values( i ) = 0.;
-                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
-                    target_values( i ) +=
-                        polynomial_coeffs( j ) * source_values( j );
+            DTK_MARK_REGION( "setup_radius_queries" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int i ) {
+                queries( i ) = ArborX::intersects( ArborX::Sphere{
+                    embedPoint( target_points, i ), radius( i )} );
             } );
         Kokkos::fence();
-
-        return target_values;
+        return queries;
     }
 
-    static Kokkos::View<Coordinate **, DeviceType> transformSourceCoordinates(
-        Kokkos::View<Coordinate const **, DeviceType> source_points,
-        Kokkos::View<int const *, DeviceType> offset,
-        Kokkos::View<Coordinate const **, DeviceType> target_points )
+    static Kokkos::View<double *, DeviceType>
+    makeConstantRadius( int n_points, double radius )
     {
-        auto const n_source_points = source_points.extent( 0 );
-        auto const n_target_points = target_points.extent( 0 );
+        Kokkos::View<double *, DeviceType> radius_field( "radius", n_points );
+        Kokkos::deep_copy( radius_field, radius );
+        return radius_field;
+    }
 
-        int const spatial_dim = 3;
-        DTK_REQUIRE( source_points.extent_int( 1 ) == spatial_dim );
-        DTK_REQUIRE( offset.extent( 0 ) == n_target_points + 1 );
+    // Replace the neighbors of the target points that have fewer than
+    // min_neighbors source points within their radius by their min_neighbors
+    // nearest neighbors. This is a collective operation.
+    template <typename SearchTree>
+    static void addNearestNeighbors(
+        MPI_Comm comm, SearchTree const &search_tree,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        unsigned int min_neighbors, Kokkos::View<int *, DeviceType> &offset,
+        Kokkos::View<int *, DeviceType> &indices,
+        Kokkos::View<int *, DeviceType> &ranks )
+    {
+        int const n_target_points = target_points.extent_int( 0 );
+        DTK_REQUIRE( offset.extent_int( 0 ) == n_target_points + 1 );
 
-        // Change the coordinates of the source points to relative position to
-        // the target points
-        Kokkos::View<Coordinate **, DeviceType> new_source_points(
-            "transformed_source_coords", n_source_points, spatial_dim );
+        // Position of each target point in the list of the target points
+        // that are missing neighbors.
+        Kokkos::View<int *, DeviceType> missing_offset( "missing_offset",
+                                                        n_target_points + 1 );
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "transform" ),
+            DTK_MARK_REGION( "count_missing_neighbors" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
-            KOKKOS_LAMBDA( const int i ) {
-                for ( int j = offset( i ); j < offset( i + 1 ); j++ )
-                    for ( int k = 0; k < spatial_dim; k++ )
-                        new_source_points( j, k ) =
-                            source_points( j, k ) - target_points( i, k );
+            KOKKOS_LAMBDA( int i ) {
+                missing_offset( i ) =
+                    ( offset( i + 1 ) - offset( i ) < (int)min_neighbors ) ? 1
+                                                                           : 0;
+            } );
+        Kokkos::fence();
+        ArborX::exclusivePrefixSum( missing_offset );
+        int const n_missing = ArborX::lastElement( missing_offset );
+
+        // The search is collective so every rank takes part as soon as one
+        // of them is missing neighbors.
+        int n_missing_global = 0;
+        MPI_Allreduce( &n_missing, &n_missing_global, 1, MPI_INT, MPI_SUM,
+                       comm );
+        if ( n_missing_global == 0 )
+            return;
+
+        int const spatial_dim = target_points.extent( 1 );
+        Kokkos::View<Coordinate **, DeviceType> missing_points(
+            "missing_points", n_missing, spatial_dim );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "compact_missing_points" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+            KOKKOS_LAMBDA( int i ) {
+                if ( missing_offset( i + 1 ) > missing_offset( i ) )
+                    for ( int d = 0; d < spatial_dim; ++d )
+                        missing_points( missing_offset( i ), d ) =
+                            target_points( i, d );
             } );
+        Kokkos::fence();
 
-        return new_source_points;
-    }
+        Kokkos::View<int *, DeviceType> knn_offset( "offset" );
+        Kokkos::View<int *, DeviceType> knn_indices( "indices" );
+        Kokkos::View<int *, DeviceType> knn_ranks( "ranks" );
+        search_tree.query( makeKNNQueries( missing_points, min_neighbors ),
+                           knn_indices, knn_offset, knn_ranks );
 
-    static Kokkos::View<double *, DeviceType>
-    computeRadius( Kokkos::View<Coordinate const **, DeviceType> source_points,
-                   Kokkos::View<int const *, DeviceType> offset )
-    {
-        unsigned int const n_target_points = offset.extent( 0 ) - 1;
-        Kokkos::View<double *, DeviceType> radius( "radius",
-                                                   source_points.extent( 0 ) );
+        // The nearest neighbors include the source points within the radius
+        // so they replace them.
+        Kokkos::View<int *, DeviceType> new_offset( offset.label(),
+                                                    n_target_points + 1 );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "count_neighbors" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+            KOKKOS_LAMBDA( int i ) {
+                int const k = missing_offset( i );
+                new_offset( i ) = ( missing_offset( i + 1 ) > k )
+                                      ? knn_offset( k + 1 ) - knn_offset( k )
+                                      : offset( i + 1 ) - offset( i );
+            } );
+        Kokkos::fence();
+        ArborX::exclusivePrefixSum( new_offset );
 
+        int const n_neighbors = ArborX::lastElement( new_offset );
+        Kokkos::View<int *, DeviceType> new_indices( indices.label(),
+                                                     n_neighbors );
+        Kokkos::View<int *, DeviceType> new_ranks( ranks.label(),
+                                                   n_neighbors );
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_radius" ),
+            DTK_MARK_REGION( "merge_neighbors" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
-            KOKKOS_LAMBDA( int const i ) {
-                // If the source point and the target point are at the same
-                // position, the radius will be zero. This is a problem since we
-                // divide by the radius in the calculation of the radial basis
-                // function. To avoid this problem, the radius has a minimal
-                // positive value.
-                double distance =
-                    10. * KokkosExt::ArithmeticTraits::epsilon<double>::value;
-                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+            KOKKOS_LAMBDA( int i ) {
+                int const k = missing_offset( i );
+                bool const missing = missing_offset( i + 1 ) > k;
+                int const first = missing ? knn_offset( k ) : offset( i );
+                for ( int j = 0; j < new_offset( i + 1 ) - new_offset( i );
+                      ++j )
                 {
-                    double new_distance = ArborX::Details::distance(
-                        ArborX::Point{{source_points( j, 0 ),
-                                       source_points( j, 1 ),
-                                       source_points( j, 2 )}},
-                        {0., 0., 0.} );
-
-                    if ( new_distance > distance )
-                        distance = new_distance;
+                    new_indices( new_offset( i ) + j ) =
+                        missing ? knn_indices( first + j )
+                                : indices( first + j );
+                    new_ranks( new_offset( i ) + j ) =
+                        missing ? knn_ranks( first + j ) : ranks( first + j );
                 }
-                // If a point is exactly on the boundary of the compact domain,
-                // its weight will be zero so we need to make sure that no point
-                // is exactly on the boundary.
-                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
-                    radius( j ) = 1.1 * distance;
             } );
+        Kokkos::fence();
 
-        return radius;
+        offset = new_offset;
+        indices = new_indices;
+        ranks = new_ranks;
     }
 
-    // We need the third argument because otherwise the compiler cannot do the
-    // template deduction. For some unknown reason, explicitly choosing the
-    // value of the template parameter does not work.
-    template <typename RBF>
-    static Kokkos::View<double *, DeviceType>
-    computeWeights( Kokkos::View<double const **, DeviceType> source_points,
-                    Kokkos::View<double const *, DeviceType> radius,
-                    RBF const & )
+    // Keep only the max_neighbors source points closest to each target point.
+    // The neighbors of a target point are partially sorted by distance in
+    // place before the lists are compacted. Returns whether any neighbor was
+    // removed.
+    static bool keepClosestNeighbors(
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        unsigned int max_neighbors, Kokkos::View<int *, DeviceType> &offset,
+        Kokkos::View<int *, DeviceType> &indices,
+        Kokkos::View<int *, DeviceType> &ranks,
+        Kokkos::View<Coordinate **, DeviceType> &source_points )
     {
-        auto const n_source_points = source_points.extent( 0 );
+        int const n_target_points = target_points.extent_int( 0 );
+        int const spatial_dim = source_points.extent_int( 1 );
+        DTK_REQUIRE( offset.extent_int( 0 ) == n_target_points + 1 );
+        DTK_REQUIRE( source_points.extent( 0 ) == indices.extent( 0 ) );
 
-        DTK_REQUIRE( source_points.extent_int( 1 ) == 3 );
+        int const n_kept_max = max_neighbors;
+        int n_removed = 0;
+        Kokkos::parallel_reduce(
+            DTK_MARK_REGION( "count_extra_neighbors" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+            KOKKOS_LAMBDA( int i, int &update ) {
+                int const n_neighbors = offset( i + 1 ) - offset( i );
+                if ( n_neighbors > n_kept_max )
+                    update += n_neighbors - n_kept_max;
+            },
+            n_removed );
+        if ( n_removed == 0 )
+            return false;
+
+        // Selection sort of the n_kept_max closest neighbors
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "select_closest_neighbors" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+            KOKKOS_LAMBDA( int i ) {
+                int const first = offset( i );
+                int const n_neighbors = offset( i + 1 ) - first;
+                if ( n_neighbors <= n_kept_max )
+                    return;
+                for ( int j = 0; j < n_kept_max; ++j )
+                {
+                    int closest = j;
+                    double closest_distance = 0.;
+                    for ( int l = j; l < n_neighbors; ++l )
+                    {
+                        double distance = 0.;
+                        for ( int d = 0; d < spatial_dim; ++d )
+                        {
+                            double const x = source_points( first + l, d ) -
+                                             target_points( i, d );
+                            distance += x * x;
+                        }
+                        if ( l == j || distance < closest_distance )
+                        {
+                            closest = l;
+                            closest_distance = distance;
+                        }
+                    }
+                    if ( closest == j )
+                        continue;
+                    int const tmp_index = indices( first + j );
+                    indices( first + j ) = indices( first + closest );
+                    indices( first + closest ) = tmp_index;
+                    int const tmp_rank = ranks( first + j );
+                    ranks( first + j ) = ranks( first + closest );
+                    ranks( first + closest ) = tmp_rank;
+                    for ( int d = 0; d < spatial_dim; ++d )
+                    {
+                        Coordinate const tmp = source_points( first + j, d );
+                        source_points( first + j, d ) =
+                            source_points( first + closest, d );
+                        source_points( first + closest, d ) = tmp;
+                    }
+                }
+            } );
+        Kokkos::fence();
 
-        // The argument of rbf is a distance because we have changed the
-        // coordinate system such the target point is the origin of the new
-        // coordinate system.
-        Kokkos::View<double *, DeviceType> phi( "weights", n_source_points );
+        Kokkos::View<int *, DeviceType> new_offset( offset.label(),
+                                                    n_target_points + 1 );
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_weights" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_source_points ),
+            DTK_MARK_REGION( "count_kept_neighbors" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
             KOKKOS_LAMBDA( int i ) {
-                RadialBasisFunction<RBF> rbf( radius( i ) );
-                phi( i ) = rbf( ArborX::Details::distance(
-                    ArborX::Point{{source_points( i, 0 ), source_points( i, 1 ),
-                                   source_points( i, 2 )}},
-                    {0., 0., 0.} ) );
+                int const n_neighbors = offset( i + 1 ) - offset( i );
+                new_offset( i ) =
+                    n_neighbors < n_kept_max ? n_neighbors : n_kept_max;
             } );
         Kokkos::fence();
-        return phi;
-    }
+        ArborX::exclusivePrefixSum( new_offset );
 
-    template <typename PolynomialBasis>
-    static Kokkos::View<double *, DeviceType>
-    computeVandermonde( Kokkos::View<double const **, DeviceType> points,
-                        PolynomialBasis const &polynomial_basis )
-    {
-        auto const n_points = points.extent( 0 );
-        auto constexpr size_polynomial_basis = PolynomialBasis::size;
-        Kokkos::View<double *, DeviceType> p(
-            "vandermonde", n_points * size_polynomial_basis );
+        int const n_neighbors = ArborX::lastElement( new_offset );
+        Kokkos::View<int *, DeviceType> new_indices( indices.label(),
+                                                     n_neighbors );
+        Kokkos::View<int *, DeviceType> new_ranks( ranks.label(),
+                                                   n_neighbors );
+        Kokkos::View<Coordinate **, DeviceType> new_source_points(
+            source_points.label(), n_neighbors, spatial_dim );
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_polynomial_basis" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            DTK_MARK_REGION( "compact_neighbors" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
             KOKKOS_LAMBDA( int i ) {
-                auto const tmp = polynomial_basis( ArborX::Point{
-                    {points( i, 0 ), points( i, 1 ), points( i, 2 )}} );
-                for ( int j = 0; j < size_polynomial_basis; ++j )
-                    p( i * size_polynomial_basis + j ) = tmp[j];
+                for ( int j = 0; j < new_offset( i + 1 ) - new_offset( i );
+                      ++j )
+                {
+                    new_indices( new_offset( i ) + j ) =
+                        indices( offset( i ) + j );
+                    new_ranks( new_offset( i ) + j ) =
+                        ranks( offset( i ) + j );
+                    for ( int d = 0; d < spatial_dim; ++d )
+                        new_source_points( new_offset( i ) + j, d ) =
+                            source_points( offset( i ) + j, d );
+                }
             } );
-        return p;
+        Kokkos::fence();
+
+        offset = new_offset;
+        indices = new_indices;
+        ranks = new_ranks;
+        source_points = new_source_points;
+
+        return true;
     }
 
-    static Kokkos::View<double *, DeviceType>
-    computeMoments( Kokkos::View<int const *, DeviceType> offset,
-                    Kokkos::View<double const *, DeviceType> p,
-                    Kokkos::View<double const *, DeviceType> phi )
+    // The coefficients may be stored with a lower precision than the values.
+    template <typename Scalar, typename Coefficient>
+    static Kokkos::View<Scalar *, DeviceType> computeTargetValues(
+        Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<Coefficient const *, DeviceType> polynomial_coeffs,
+        Kokkos::View<Scalar const *, DeviceType> source_values )
     {
         auto const n_target_points = offset.extent_int( 0 ) - 1;
-        auto const n_source_points = phi.extent_int( 0 );
-        DTK_REQUIRE( n_source_points == ArborX::lastElement( offset ) );
-        if ( n_source_points == 0 )
-            return Kokkos::View<double *, DeviceType>( "moments" );
-        auto const size_polynomial_basis = p.extent_int( 0 ) / n_source_points;
-        auto const size_polynomial_basis_squared =
-            size_polynomial_basis * size_polynomial_basis;
-        Kokkos::View<double *, DeviceType> a(
-            "moments", n_target_points * size_polynomial_basis_squared );
+        Kokkos::View<Scalar *, DeviceType> target_values(
+            std::string( "target_" ) + source_values.label(), n_target_points );
+
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_moments" ),
+            DTK_MARK_REGION( "compute_values" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
-            KOKKOS_LAMBDA( int i ) {
-                auto p_i = Kokkos::subview(
-                    p, Kokkos::make_pair( offset( i ) * size_polynomial_basis,
-                                          offset( i + 1 ) *
-                                              size_polynomial_basis ) );
-                auto phi_i = Kokkos::subview(
-                    phi, Kokkos::make_pair( offset( i ), offset( i + 1 ) ) );
-                auto a_i = Kokkos::subview(
-                    a, Kokkos::make_pair( i * size_polynomial_basis_squared,
-                                          ( i + 1 ) *
-                                              size_polynomial_basis_squared ) );
-                for ( int j = 0; j < size_polynomial_basis; ++j )
-                    for ( int k = 0; k < size_polynomial_basis; ++k )
-                    {
-                        double tmp = 0.;
-                        for ( int l = 0; l < offset( i + 1 ) - offset( i );
-                              ++l )
-                            // Compute value (j,k)
-                            tmp += p_i( l * size_polynomial_basis + j ) *
-                                   phi_i( l ) *
-                                   p_i( l * size_polynomial_basis + k );
-                        a_i( j * size_polynomial_basis + k ) = tmp;
-                    }
+            KOKKOS_LAMBDA( const int i ) {
+                target_values( i ) = 0.;
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                    target_values( i ) +=
+                        polynomial_coeffs( j ) * source_values( j );
             } );
         Kokkos::fence();
 
-        return a;
+        return target_values;
     }
 
-    // Matrix pseudo-inversion using SVD
-    // Takes in a 1D array of matrices of size NxN, and returns a 1D array of
-    // matrices of the same size containing corresponding pseudo-inverses
-    static std::tuple<Kokkos::View<double *, DeviceType>, size_t>
-    invertMoments( Kokkos::View<double const *, DeviceType> a,
-                   const int size_polynomial_basis )
+    // Multi-field version. The contraction with the coefficients is done for
+    // all the components of a target point at once.
+    template <typename Scalar, typename Coefficient>
+    static void computeTargetValues(
+        Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<Coefficient const *, DeviceType> polynomial_coeffs,
+        Kokkos::View<Scalar const **, DeviceType> source_values,
+        Kokkos::View<Scalar **, DeviceType> target_values )
     {
-        Kokkos::View<double *, DeviceType> inv_a( "inv_a", a.extent( 0 ) );
-
-        auto num_matrices =
-            a.extent( 0 ) / ( size_polynomial_basis * size_polynomial_basis );
-
-        // We request auxiliary space for matrices E, U, and V (thus, 3) that
-        // we need inside SVD. Single level parallelism does not provide access
-        // to scratch space (or, at the least, I don't know how to access it).
-        // So we preallocate it here, and pass to the functor. We use 2D array
-        // as we would like to use 2D matrices inside SVD, and there is no way
-        // to reshape.
-        Kokkos::View<double **, DeviceType> aux( "aux", size_polynomial_basis,
-                                                 3 * num_matrices *
-                                                     size_polynomial_basis );
-
-        SVDFunctor<DeviceType> svdFunctor( size_polynomial_basis, a, inv_a,
-                                           aux );
-        size_t num_underdetermined = 0;
-        Kokkos::parallel_reduce(
-            DTK_MARK_REGION( "compute_svd_inverse" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, num_matrices ), svdFunctor,
-            num_underdetermined );
+        auto const n_target_points = offset.extent_int( 0 ) - 1;
+        auto const n_components = source_values.extent_int( 1 );
+        DTK_REQUIRE( target_values.extent_int( 0 ) == n_target_points );
+        DTK_REQUIRE( target_values.extent_int( 1 ) == n_components );
 
-        return std::make_tuple( inv_a, num_underdetermined );
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "compute_values" ),
+            Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<2>>(
+                {{0, 0}}, {{n_target_points, n_components}} ),
+            KOKKOS_LAMBDA( int const i, int const k ) {
+                Scalar tmp = 0.;
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                    tmp += polynomial_coeffs( j ) * source_values( j, k );
+                target_values( i, k ) = tmp;
+            } );
+        Kokkos::fence();
+    }
+
+    // Contraction restricted to the neighbors owned by \p comm_rank if
+    // \p local is true, or to the other neighbors otherwise. The local
+    // contributions overwrite the target values while the remote ones are
+    // added to them. This allows to compute the local part while the remote
+    // source values are still being communicated.
+    template <typename Coefficient>
+    static void computePartialTargetValues(
+        Kokkos::View<int const *, DeviceType> offset,
+        Kokkos::View<Coefficient const *, DeviceType> polynomial_coeffs,
+        Kokkos::View<int const *, DeviceType> ranks, int comm_rank, bool local,
+        Kokkos::View<double const **, DeviceType> source_values,
+        Kokkos::View<double **, DeviceType> target_values )
+    {
+        auto const n_target_points = offset.extent_int( 0 ) - 1;
+        auto const n_components = source_values.extent_int( 1 );
+        DTK_REQUIRE( target_values.extent_int( 0 ) == n_target_points );
+        DTK_REQUIRE( target_values.extent_int( 1 ) == n_components );
+
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "compute_partial_values" ),
+            Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<2>>(
+                {{0, 0}}, {{n_target_points, n_components}} ),
+            KOKKOS_LAMBDA( int const i, int const k ) {
+                double tmp = 0.;
+                for ( int j = offset( i ); j < offset( i + 1 ); ++j )
+                    if ( ( ranks( j ) == comm_rank ) == local )
+                        tmp += polynomial_coeffs( j ) * source_values( j, k );
+                if ( local )
+                    target_values( i, k ) = tmp;
+                else
+                    target_values( i, k ) += tmp;
+            } );
+        Kokkos::fence();
+    }
+
+    // Copy the values with a different precision, e.g., to store the
+    // coefficients in single precision.
+    template <typename Scalar, typename View>
+    static Kokkos::View<Scalar *, DeviceType> castValues( View const &values )
+    {
+        static_assert( View::rank == 1, "castValues() requires a rank-1 View" );
+        auto const n = values.extent_int( 0 );
+        Kokkos::View<Scalar *, DeviceType> cast_values( values.label(), n );
+        Kokkos::parallel_for( DTK_MARK_REGION( "cast_values" ),
+                              Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+                              KOKKOS_LAMBDA( int const i ) {
+                                  cast_values( i ) =
+                                      static_cast<Scalar>( values( i ) );
+                              } );
+        Kokkos::fence();
+
+        return cast_values;
     }
 
-    static Kokkos::View<double *, DeviceType> computePolynomialCoefficients(
+    // Fused setup that handles one target point per team.  The Vandermonde
+    // matrix, the weights, the moment matrix, and its decomposition only live
+    // in team scratch memory, and the polynomial coefficients are the only
+    // values written to global memory.  When \p radius is not empty, it gives
+    // the support radius of the weights of each target point.  When
+    // \p n_ill_conditioned is allocated, it is incremented for each target
+    // point whose moment matrix had to be inverted with the SVD.
+    template <typename RBF, typename PolynomialBasis>
+    static Kokkos::View<double *, DeviceType>
+    computePolynomialCoefficientsFused(
         Kokkos::View<int const *, DeviceType> offset,
-        Kokkos::View<double const *, DeviceType> inv_a,
-        Kokkos::View<double const *, DeviceType> p,
-        Kokkos::View<double const *, DeviceType> phi,
-        const int size_polynomial_basis )
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        RBF const &, PolynomialBasis const &polynomial_basis,
+        Kokkos::View<double const *, DeviceType> radius =
+            Kokkos::View<double const *, DeviceType>(),
+        Kokkos::View<int, DeviceType> n_ill_conditioned =
+            Kokkos::View<int, DeviceType>() )
     {
-        auto const size_polynomial_basis_squared =
-            size_polynomial_basis * size_polynomial_basis;
+        auto const n_source_points = source_points.extent_int( 0 );
+        auto const n_target_points = target_points.extent_int( 0 );
+        auto constexpr size_polynomial_basis = PolynomialBasis::size;
 
-        auto num_matrices = inv_a.extent( 0 ) / size_polynomial_basis_squared;
+        int const spatial_dim = PolynomialBasis::dimension;
+        DTK_REQUIRE( source_points.extent_int( 1 ) == spatial_dim );
+        DTK_REQUIRE( target_points.extent_int( 1 ) == spatial_dim );
+        DTK_REQUIRE( offset.extent_int( 0 ) == n_target_points + 1 );
+        bool const use_radius = radius.extent( 0 ) > 0;
+        DTK_REQUIRE( !use_radius || radius.extent_int( 0 ) == n_target_points );
+        bool const count_ill_conditioned = n_ill_conditioned.data() != nullptr;
 
         Kokkos::View<double *, DeviceType> coeffs( "polynomial_coeffs",
-                                                   phi.extent( 0 ) );
+                                                   n_source_points );
+        if ( n_target_points == 0 )
+            return coeffs;
+
+        // The scratch memory is sized for the largest neighborhood.
+        int max_neighbors = 0;
+        Kokkos::parallel_reduce(
+            DTK_MARK_REGION( "compute_max_neighbors" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
+            KOKKOS_LAMBDA( int const i, int &update ) {
+                int const n_neighbors = offset( i + 1 ) - offset( i );
+                if ( n_neighbors > update )
+                    update = n_neighbors;
+            },
+            Kokkos::Max<int>( max_neighbors ) );
+
+        using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
+        using ScratchSpace = typename ExecutionSpace::scratch_memory_space;
+        using ScratchMatrix =
+            Kokkos::View<double **, ScratchSpace, Kokkos::MemoryUnmanaged>;
+        using ScratchVector =
+            Kokkos::View<double *, ScratchSpace, Kokkos::MemoryUnmanaged>;
+
+        // Vandermonde matrix and weights of the neighbors, and the first row
+        // of the inverse of the moment matrix. The moment matrix itself is
+        // only held in registers. The large neighborhoods that do not fit in
+        // the level-0 scratch, e.g. the shared memory of a GPU, use the
+        // slower level-1 scratch.
+        std::size_t const scratch_size =
+            ScratchMatrix::shmem_size( max_neighbors, size_polynomial_basis ) +
+            ScratchVector::shmem_size( max_neighbors ) +
+            ScratchVector::shmem_size( size_polynomial_basis );
+        int const scratch_level =
+            scratch_size > static_cast<std::size_t>(
+                               TeamPolicy::scratch_size_max( 0 ) )
+                ? 1
+                : 0;
+        DTK_INSIST( scratch_size <= static_cast<std::size_t>(
+                                        TeamPolicy::scratch_size_max(
+                                            scratch_level ) ) );
 
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "compute_polynomial_coeffs" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, num_matrices ),
-            KOKKOS_LAMBDA( const int i ) {
-                auto p_i = Kokkos::subview(
-                    p, Kokkos::make_pair( offset( i ) * size_polynomial_basis,
-                                          offset( i + 1 ) *
-                                              size_polynomial_basis ) );
-                auto phi_i = Kokkos::subview(
-                    phi, Kokkos::make_pair( offset( i ), offset( i + 1 ) ) );
-                auto inv_a_i = Kokkos::subview(
-                    inv_a, Kokkos::make_pair(
-                               i * size_polynomial_basis_squared,
-                               ( i + 1 ) * size_polynomial_basis_squared ) );
-                auto coeffs_i = Kokkos::subview(
-                    coeffs, Kokkos::make_pair( offset( i ), offset( i + 1 ) ) );
+            DTK_MARK_REGION( "compute_polynomial_coeffs_fused" ),
+            TeamPolicy( n_target_points, Kokkos::AUTO )
+                .set_scratch_size( scratch_level,
+                                   Kokkos::PerTeam( scratch_size ) ),
+            KOKKOS_LAMBDA( typename TeamPolicy::member_type const &team ) {
+                int const i = team.league_rank();
+                int const first = offset( i );
+                int const n_neighbors = offset( i + 1 ) - first;
+
+                ScratchMatrix p( team.team_scratch( scratch_level ),
+                                 n_neighbors, size_polynomial_basis );
+                ScratchVector phi( team.team_scratch( scratch_level ),
+                                   n_neighbors );
+                ScratchVector inv_a_0( team.team_scratch( scratch_level ),
+                                       size_polynomial_basis );
+
+                // Change the coordinates of the source points to relative
+                // position to the target point and build the Vandermonde
+                // matrix. The distances to the target are stored in phi until
+                // the radius is known.
+                double distance = 0.;
+                Kokkos::parallel_reduce(
+                    Kokkos::TeamThreadRange( team, n_neighbors ),
+                    [&]( int const j, double &update ) {
+                        ArborX::Point x_j = {{0., 0., 0.}};
+                        for ( int d = 0; d < spatial_dim; ++d )
+                            x_j[d] = source_points( first + j, d ) -
+                                     target_points( i, d );
+                        auto const p_j = polynomial_basis( x_j );
+                        for ( int k = 0; k < size_polynomial_basis; ++k )
+                            p( j, k ) = p_j[k];
+                        phi( j ) =
+                            ArborX::Details::distance( x_j, {0., 0., 0.} );
+                        if ( phi( j ) > update )
+                            update = phi( j );
+                    },
+                    Kokkos::Max<double>( distance ) );
+                team.team_barrier();
+
+                // The support radius is 10% larger than the distance to the
+                // farthest neighbor unless the radius given is larger.
+                double const min_distance =
+                    10. * KokkosExt::ArithmeticTraits::epsilon<double>::value;
+                if ( distance < min_distance )
+                    distance = min_distance;
+                RadialBasisFunction<RBF> rbf(
+                    ( use_radius && radius( i ) > distance ) ? radius( i )
+                                                             : 1.1 * distance );
+
+                // Evaluate the weights and accumulate the moment matrix in a
+                // single pass over the neighbors. Each neighbor contributes a
+                // rank-1 update to the upper triangle of the matrix.
+                PackedSymmetricMatrix<size_polynomial_basis> a;
+                Kokkos::parallel_reduce(
+                    Kokkos::TeamThreadRange( team, n_neighbors ),
+                    [&]( int const j,
+                         PackedSymmetricMatrix<size_polynomial_basis>
+                             &update ) {
+                        phi( j ) = rbf( phi( j ) );
+                        Kokkos::Array<double, size_polynomial_basis> p_j;
+                        for ( int k = 0; k < size_polynomial_basis; ++k )
+                            p_j[k] = p( j, k );
+                        update.rankOneUpdate( phi( j ), p_j );
+                    },
+                    a );
+                team.team_barrier();
+
+                // Only the first row of the inverse is needed since the
+                // coefficients are c_j = phi_j (A^-1 p_j)_0 for a basis whose
+                // only nonzero term at the origin is the first one. The
+                // moment matrix is symmetric so it is obtained with an LDL^T
+                // solve in registers, and the SVD is only used for
+                // rank-deficient matrices.
+                Kokkos::single( Kokkos::PerTeam( team ), [&]() {
+                    SquareMatrix<size_polynomial_basis> a_i;
+                    for ( int j = 0; j < size_polynomial_basis; ++j )
+                        for ( int k = 0; k < size_polynomial_basis; ++k )
+                            a_i( j, k ) = a( j, k );
+                    Kokkos::Array<double, size_polynomial_basis> x;
+                    bool const rank_deficient =
+                        SymmetricSolver<DeviceType, size_polynomial_basis>::
+                            firstRowOfInverse( a_i, x );
+                    if ( rank_deficient && count_ill_conditioned )
+                        Kokkos::atomic_increment( &n_ill_conditioned() );
+                    for ( int j = 0; j < size_polynomial_basis; ++j )
+                        inv_a_0( j ) = x[j];
+                } );
+                team.team_barrier();
 
                 // coeffs = [1 0 ... 0] * a_inv * p^T * phi
-                for ( int k = 0; k < offset( i + 1 ) - offset( i ); k++ )
-                {
-                    coeffs_i( k ) = 0.;
-                    for ( int j = 0; j < size_polynomial_basis; j++ )
-                        coeffs_i( k ) +=
-                            inv_a_i( 0 * size_polynomial_basis + j ) *
-                            p_i( k * size_polynomial_basis + j ) * phi_i( k );
-                }
+                Kokkos::parallel_for(
+                    Kokkos::TeamThreadRange( team, n_neighbors ),
+                    [&]( int const l ) {
+                        double value = 0.;
+                        for ( int j = 0; j < size_polynomial_basis; ++j )
+                            value += inv_a_0( j ) * p( l, j );
+                        coeffs( first + l ) = value * phi( l );
+                    } );
             } );
+        Kokkos::fence();
+
         return coeffs;
     }
 };
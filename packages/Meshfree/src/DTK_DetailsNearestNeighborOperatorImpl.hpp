@@ -14,12 +14,55 @@
 
 #include <ArborX.hpp>
 #include <DTK_DBC.hpp>
+#include <DTK_DetailsDistributor.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 namespace DataTransferKit
 {
 namespace Details
 {
 
+// ArborX only handles three-dimensional geometry. The points of a lower
+// dimension are embedded in the plane z = 0 for the search.
+template <typename View>
+KOKKOS_INLINE_FUNCTION ArborX::Point embedPoint( View const &points, int i )
+{
+    ArborX::Point point = {{0., 0., 0.}};
+    for ( int d = 0; d < (int)points.extent( 1 ); ++d )
+        point[d] = points( i, d );
+    return point;
+}
+
+// Copy of the points with three coordinates to build a search tree. The
+// points are returned as is if they are already three-dimensional.
+template <typename DeviceType>
+Kokkos::View<Coordinate const **, DeviceType>
+embedPoints( Kokkos::View<Coordinate const **, DeviceType> points )
+{
+    int const spatial_dim = 3;
+    if ( points.extent_int( 1 ) == spatial_dim )
+        return points;
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    int const n_points = points.extent( 0 );
+    Kokkos::View<Coordinate **, DeviceType> embedded_points(
+        "embedded_" + points.label(), n_points, spatial_dim );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "embed_points" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+        KOKKOS_LAMBDA( int i ) {
+            auto const point = embedPoint( points, i );
+            for ( int d = 0; d < spatial_dim; ++d )
+                embedded_points( i, d ) = point[d];
+        } );
+    Kokkos::fence();
+    return embedded_points;
+}
+
 template <typename DeviceType>
 struct NearestNeighborOperatorImpl
 {
@@ -36,111 +79,233 @@ struct NearestNeighborOperatorImpl
             DTK_MARK_REGION( "setup_queries" ),
             Kokkos::RangePolicy<ExecutionSpace>( 0, n_target_points ),
             KOKKOS_LAMBDA( int i ) {
-                nearest_queries( i ) = nearest(
-                    ArborX::Point{{target_points( i, 0 ), target_points( i, 1 ),
-                                   target_points( i, 2 )}} );
+                nearest_queries( i ) =
+                    nearest( embedPoint( target_points, i ) );
             } );
         Kokkos::fence();
         return nearest_queries;
     }
 
-    template <typename View>
-    static void
-    pullSourceValues( MPI_Comm comm, View source_values,
-                      Kokkos::View<int *, DeviceType> &buffer_indices,
-                      Kokkos::View<int *, DeviceType> &buffer_ranks,
-                      typename View::non_const_type &buffer_values )
+    // Build the communication plan that moves values from the ranks owning
+    // the source points to the ranks that requested them.  The requests,
+    // i.e. the (rank, index) pairs of the source points, are sent once to the
+    // owning ranks.  On return, \p distributor sends values back to the
+    // requesting ranks, \p export_source_indices are the local indices of the
+    // source values to pack before sending, and \p import_target_indices are
+    // the positions in the request list of the values received.
+    static void setupCommunicationPlan(
+        MPI_Comm comm, Kokkos::View<int *, DeviceType> ranks,
+        Kokkos::View<int *, DeviceType> indices,
+        Distributor<DeviceType> &distributor,
+        Kokkos::View<int *, DeviceType> &export_source_indices,
+        Kokkos::View<int *, DeviceType> &import_target_indices )
     {
-        static_assert(
-            View::rank <= 2,
-            "pullSourceValues() requires rank-1 or rank-2 view arguments" );
-        int const n_exports = buffer_indices.extent( 0 );
-        ArborX::Details::Distributor<DeviceType> distributor( comm );
-        int const n_imports = distributor.createFromSends( buffer_ranks );
+        DTK_REQUIRE( ranks.extent( 0 ) == indices.extent( 0 ) );
+
+        int const n_requests = ranks.extent( 0 );
+        ArborX::Details::Distributor<DeviceType> request_distributor( comm );
+        int const n_imports = request_distributor.createFromSends( ranks );
 
         Kokkos::View<int *, DeviceType> export_target_indices( "target_indices",
-                                                               n_exports );
+                                                               n_requests );
         ArborX::iota( export_target_indices );
-        Kokkos::View<int *, DeviceType> import_target_indices( "target_indices",
-                                                               n_imports );
-        ArborX::Details::DistributedSearchTreeImpl<
-            DeviceType>::sendAcrossNetwork( distributor, export_target_indices,
-                                            import_target_indices );
+        Kokkos::View<int *, DeviceType> requested_target_indices(
+            "target_indices", n_imports );
+        ArborX::Details::DistributedSearchTreeImpl<DeviceType>::
+            sendAcrossNetwork( request_distributor, export_target_indices,
+                               requested_target_indices );
 
-        Kokkos::View<int *, DeviceType> export_source_indices = buffer_indices;
-        Kokkos::View<int *, DeviceType> import_source_indices( "source_indices",
-                                                               n_imports );
+        Kokkos::realloc( export_source_indices, n_imports );
         ArborX::Details::DistributedSearchTreeImpl<
-            DeviceType>::sendAcrossNetwork( distributor, export_source_indices,
-                                            import_source_indices );
+            DeviceType>::sendAcrossNetwork( request_distributor, indices,
+                                            export_source_indices );
 
-        Kokkos::View<int *, DeviceType> export_ranks( "ranks", n_exports );
+        Kokkos::View<int *, DeviceType> export_ranks( "ranks", n_requests );
         Kokkos::View<int *, DeviceType> import_ranks( "ranks", n_imports );
         int comm_rank;
         MPI_Comm_rank( comm, &comm_rank );
         Kokkos::deep_copy( export_ranks, comm_rank );
         ArborX::Details::DistributedSearchTreeImpl<
-            DeviceType>::sendAcrossNetwork( distributor, export_ranks,
+            DeviceType>::sendAcrossNetwork( request_distributor, export_ranks,
                                             import_ranks );
 
-        buffer_indices = import_target_indices;
-        buffer_ranks = import_ranks;
-        Kokkos::realloc( buffer_values, n_imports, source_values.extent( 1 ) );
+        // The values travel in the opposite direction of the requests so we
+        // need a second distributor.
+        int const n_values = distributor.createFromSends( import_ranks );
+        DTK_CHECK( n_values == n_requests );
+
+        Kokkos::realloc( import_target_indices, n_values );
+        distributor.doPostsAndWaits( requested_target_indices,
+                                     import_target_indices );
+    }
+
+    // Number the distinct source points of the request list, i.e. the
+    // distinct (rank, index) pairs, in increasing order of rank and then of
+    // index.  On return, \p columns is the number of the source point of each
+    // request, and \p column_ranks and \p column_indices describe the
+    // distinct source points.  This is done once at setup on the host.
+    static void makeColumnMap( Kokkos::View<int const *, DeviceType> ranks,
+                               Kokkos::View<int const *, DeviceType> indices,
+                               Kokkos::View<int *, DeviceType> &columns,
+                               Kokkos::View<int *, DeviceType> &column_ranks,
+                               Kokkos::View<int *, DeviceType> &column_indices )
+    {
+        DTK_REQUIRE( ranks.extent( 0 ) == indices.extent( 0 ) );
+
+        int const n_requests = ranks.extent( 0 );
+        Kokkos::View<int *, Kokkos::HostSpace> ranks_host( "ranks",
+                                                           n_requests );
+        Kokkos::deep_copy( ranks_host, ranks );
+        Kokkos::View<int *, Kokkos::HostSpace> indices_host( "indices",
+                                                             n_requests );
+        Kokkos::deep_copy( indices_host, indices );
+
+        std::vector<int> permutation( n_requests );
+        std::iota( permutation.begin(), permutation.end(), 0 );
+        std::sort( permutation.begin(), permutation.end(),
+                   [&]( int i, int j ) {
+                       return std::make_pair( ranks_host( i ),
+                                              indices_host( i ) ) <
+                              std::make_pair( ranks_host( j ),
+                                              indices_host( j ) );
+                   } );
+
+        Kokkos::realloc( columns, n_requests );
+        auto columns_host = Kokkos::create_mirror_view( columns );
+        std::vector<int> unique_ranks;
+        std::vector<int> unique_indices;
+        for ( int i : permutation )
+        {
+            if ( unique_ranks.empty() ||
+                 ranks_host( i ) != unique_ranks.back() ||
+                 indices_host( i ) != unique_indices.back() )
+            {
+                unique_ranks.push_back( ranks_host( i ) );
+                unique_indices.push_back( indices_host( i ) );
+            }
+            columns_host( i ) = unique_ranks.size() - 1;
+        }
+        Kokkos::deep_copy( columns, columns_host );
+
+        int const n_columns = unique_ranks.size();
+        Kokkos::realloc( column_ranks, n_columns );
+        Kokkos::realloc( column_indices, n_columns );
+        auto column_ranks_host = Kokkos::create_mirror_view( column_ranks );
+        auto column_indices_host = Kokkos::create_mirror_view( column_indices );
+        for ( int j = 0; j < n_columns; ++j )
+        {
+            column_ranks_host( j ) = unique_ranks[j];
+            column_indices_host( j ) = unique_indices[j];
+        }
+        Kokkos::deep_copy( column_ranks, column_ranks_host );
+        Kokkos::deep_copy( column_indices, column_indices_host );
+    }
+
+    // Unpack the rows [first, last) of the values received in the order of
+    // the request list.
+    template <typename View>
+    static void
+    unpack( Kokkos::View<int const *, DeviceType> import_target_indices,
+            View import_values, View values_out, int first, int last )
+    {
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "get_source_values" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+            DTK_MARK_REGION( "unpack_target_values" ),
+            Kokkos::RangePolicy<ExecutionSpace>( first, last ),
             KOKKOS_LAMBDA( int i ) {
-                // TODO Using Kokkos::View::access() is a workaround.
-                // We should write specializations for rank-1 and rank-2
-                // objects.
-                for ( int j = 0; j < (int)source_values.extent( 1 ); ++j )
-                    buffer_values.access( i, j ) =
-                        source_values.access( import_source_indices( i ), j );
+                for ( int j = 0; j < (int)values_out.extent( 1 ); ++j )
+                    values_out.access( import_target_indices( i ), j ) =
+                        import_values.access( i, j );
             } );
         Kokkos::fence();
     }
 
+    // Pack the source values and post their exchange using a communication
+    // plan previously built with setupCommunicationPlan().  \p values_out is
+    // indexed like the request list, i.e. like the ranks and indices used to
+    // build the plan.  On return, only the values owned by this rank have
+    // been unpacked in \p values_out.  \p import_values receives the values
+    // and must be kept until fetchEnd() is called.
     template <typename View>
     static void
-    pushTargetValues( MPI_Comm comm,
-                      Kokkos::View<int *, DeviceType> const &buffer_indices,
-                      Kokkos::View<int *, DeviceType> const &buffer_ranks,
-                      View const &buffer_values, View target_values )
+    fetchBegin( Distributor<DeviceType> &distributor,
+                Kokkos::View<int const *, DeviceType> export_source_indices,
+                Kokkos::View<int const *, DeviceType> import_target_indices,
+                View values, typename View::non_const_type import_values,
+                typename View::non_const_type values_out )
     {
-        static_assert(
-            View::rank <= 2,
-            "pushTargetValues() requires rank-1 or rank-2 view arguments" );
-        ArborX::Details::Distributor<DeviceType> distributor( comm );
-        int const n_imports = distributor.createFromSends( buffer_ranks );
-
-        View export_source_values = buffer_values;
-        View import_source_values( "source_values", n_imports,
-                                   target_values.extent( 1 ) );
-        ArborX::Details::DistributedSearchTreeImpl<
-            DeviceType>::sendAcrossNetwork( distributor, export_source_values,
-                                            import_source_values );
-
-        Kokkos::View<int *, DeviceType> export_target_indices = buffer_indices;
-        Kokkos::View<int *, DeviceType> import_target_indices( "target_indices",
-                                                               n_imports );
-        ArborX::Details::DistributedSearchTreeImpl<
-            DeviceType>::sendAcrossNetwork( distributor, export_target_indices,
-                                            import_target_indices );
+        static_assert( View::rank <= 2,
+                       "fetch() requires rank-1 or rank-2 view arguments" );
+        int const n_exports = export_source_indices.extent( 0 );
+        DTK_REQUIRE( distributor.getTotalReceiveLength() ==
+                     import_target_indices.extent( 0 ) );
+        DTK_REQUIRE( import_values.extent( 0 ) ==
+                     import_target_indices.extent( 0 ) );
+        DTK_REQUIRE( values_out.extent( 0 ) ==
+                     import_target_indices.extent( 0 ) );
+        DTK_REQUIRE( import_values.extent( 1 ) == values.extent( 1 ) );
+        DTK_REQUIRE( values_out.extent( 1 ) == values.extent( 1 ) );
 
+        typename View::non_const_type export_values(
+            "export_" + values.label(), n_exports, values.extent( 1 ) );
         Kokkos::parallel_for(
-            DTK_MARK_REGION( "set_target_values" ),
-            Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+            DTK_MARK_REGION( "pack_source_values" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_exports ),
             KOKKOS_LAMBDA( int i ) {
                 // TODO Using Kokkos::View::access() is a workaround.
                 // We should write specializations for rank-1 and rank-2
                 // objects.
-                for ( int j = 0; j < (int)target_values.extent( 1 ); ++j )
-                    target_values.access( import_target_indices( i ), j ) =
-                        import_source_values.access( i, j );
+                for ( int j = 0; j < (int)values.extent( 1 ); ++j )
+                    export_values.access( i, j ) =
+                        values.access( export_source_indices( i ), j );
             } );
         Kokkos::fence();
+
+        distributor.doPosts( export_values, import_values );
+
+        auto const self_range = distributor.getSelfReceiveRange();
+        unpack( import_target_indices, import_values, values_out,
+                self_range.first, self_range.second );
+    }
+
+    // Wait for the values posted by fetchBegin() and unpack the values owned
+    // by the other ranks in \p values_out.
+    template <typename View>
+    static void
+    fetchEnd( Distributor<DeviceType> &distributor,
+              Kokkos::View<int const *, DeviceType> import_target_indices,
+              View import_values, View values_out )
+    {
+        distributor.doWaits( import_values );
+
+        auto const self_range = distributor.getSelfReceiveRange();
+        unpack( import_target_indices, import_values, values_out, 0,
+                self_range.first );
+        unpack( import_target_indices, import_values, values_out,
+                self_range.second, import_target_indices.extent_int( 0 ) );
+    }
+
+    // Send the source values using a communication plan previously built with
+    // setupCommunicationPlan().  \p values_out is indexed like the request
+    // list, i.e. like the ranks and indices used to build the plan.
+    template <typename View>
+    static void
+    fetch( Distributor<DeviceType> &distributor,
+           Kokkos::View<int const *, DeviceType> export_source_indices,
+           Kokkos::View<int const *, DeviceType> import_target_indices,
+           View values, typename View::non_const_type values_out )
+    {
+        typename View::non_const_type import_values(
+            "import_" + values.label(), import_target_indices.extent( 0 ),
+            values.extent( 1 ) );
+        fetchBegin( distributor, export_source_indices, import_target_indices,
+                    values, import_values, values_out );
+        fetchEnd( distributor, import_target_indices, import_values,
+                  values_out );
     }
 
+    // Send the source values in a single blocking exchange.  The plan is
+    // built for this call only, so it borrows the communicator rather than
+    // duplicating it.
     template <typename View>
     static typename View::non_const_type
     fetch( MPI_Comm comm, Kokkos::View<int const *, DeviceType> ranks,
@@ -156,16 +321,19 @@ struct NearestNeighborOperatorImpl
             Kokkos::create_mirror( DeviceType(), indices );
         Kokkos::deep_copy( buffer_indices, indices );
 
-        typename View::non_const_type buffer_values( values.label() );
-
-        pullSourceValues( comm, values, buffer_indices, buffer_ranks,
-                          buffer_values );
+        Distributor<DeviceType> distributor( comm, CommunicatorUse::Borrow );
+        Kokkos::View<int *, DeviceType> export_source_indices(
+            "source_indices" );
+        Kokkos::View<int *, DeviceType> import_target_indices(
+            "target_indices" );
+        setupCommunicationPlan( comm, buffer_ranks, buffer_indices,
+                                distributor, export_source_indices,
+                                import_target_indices );
 
         typename View::non_const_type values_out(
             values.label(), ranks.extent( 0 ), values.extent( 1 ) );
-
-        pushTargetValues( comm, buffer_indices, buffer_ranks, buffer_values,
-                          values_out );
+        fetch( distributor, export_source_indices, import_target_indices,
+               values, values_out );
 
         DTK_ENSURE( ( values_out.extent( 0 ) == ranks.extent( 0 ) ) &&
                     ( values_out.extent( 1 ) == values.extent( 1 ) ) );
@@ -54,8 +54,9 @@ struct SVDFunctor
     {
     }
 
-    KOKKOS_INLINE_FUNCTION
-    void givens_left( matrix_type A, double c, double s, int i, int k ) const
+    template <typename Matrix>
+    KOKKOS_INLINE_FUNCTION static void givens_left( Matrix &A, double c,
+                                                    double s, int i, int k )
     {
         auto n = A.extent_int( 0 );
 
@@ -68,8 +69,9 @@ struct SVDFunctor
         }
     }
 
-    KOKKOS_INLINE_FUNCTION
-    void givens_right( matrix_type A, double c, double s, int i, int k ) const
+    template <typename Matrix>
+    KOKKOS_INLINE_FUNCTION static void givens_right( Matrix &A, double c,
+                                                     double s, int i, int k )
     {
         auto n = A.extent_int( 0 );
 
@@ -83,7 +85,7 @@ struct SVDFunctor
     }
 
     KOKKOS_INLINE_FUNCTION
-    void trans_2x2( matrix_2x2_type const &A, matrix_2x2_type &B ) const
+    static void trans_2x2( matrix_2x2_type const &A, matrix_2x2_type &B )
     {
         B = {{{{A[0][0], A[1][0]}}, {{A[0][1], A[1][1]}}}};
     }
@@ -99,8 +101,8 @@ struct SVDFunctor
     }
 
     KOKKOS_INLINE_FUNCTION
-    void mult_2x2( matrix_2x2_type const &A, matrix_2x2_type const &B,
-                   matrix_2x2_type &C ) const
+    static void mult_2x2( matrix_2x2_type const &A, matrix_2x2_type const &B,
+                          matrix_2x2_type &C )
     {
         C = {{{{A[0][0] * B[0][0] + A[0][1] * B[1][0],
                 A[0][0] * B[0][1] + A[0][1] * B[1][1]}},
@@ -109,8 +111,8 @@ struct SVDFunctor
     }
 
     KOKKOS_INLINE_FUNCTION
-    void svd_2x2( matrix_2x2_type const &A, matrix_2x2_type &U,
-                  matrix_2x2_type &E, matrix_2x2_type &V ) const
+    static void svd_2x2( matrix_2x2_type const &A, matrix_2x2_type &U,
+                         matrix_2x2_type &E, matrix_2x2_type &V )
     {
         matrix_2x2_type At, AAt, AtA;
         trans_2x2( A, At );
@@ -153,9 +155,9 @@ struct SVDFunctor
         mult_2x2( W, C, V );
     }
 
-    KOKKOS_INLINE_FUNCTION
-    void argmax_off_diagonal( typename matrix_type::const_type A, int &p,
-                              int &q ) const
+    template <typename Matrix>
+    KOKKOS_INLINE_FUNCTION static void argmax_off_diagonal( Matrix const &A,
+                                                            int &p, int &q )
     {
         const auto n = A.extent_int( 0 );
 
@@ -173,8 +175,8 @@ struct SVDFunctor
                 }
     }
 
-    KOKKOS_INLINE_FUNCTION
-    double norm_F_wo_diag( typename matrix_type::const_type A ) const
+    template <typename Matrix>
+    KOKKOS_INLINE_FUNCTION static double norm_F_wo_diag( Matrix const &A )
     {
         const auto n = A.extent_int( 0 );
 
@@ -186,40 +188,21 @@ struct SVDFunctor
         return std::sqrt( norm );
     }
 
-    KOKKOS_INLINE_FUNCTION
-    void operator()( const int matrix_id, size_t &num_underdetermined ) const
+    // One-sided Jacobi iterations.  On entry, E is the n x n matrix to
+    // decompose.  On exit, E is diagonal and contains the singular values, and
+    // U and V are such that the original matrix is U E V (note that V is
+    // stored transposed).  The matrices only need to provide operator()(i, j)
+    // and extent_int(0) so that they can be views in team scratch memory or
+    // fixed-size matrices held in registers (see SquareMatrix).  They are
+    // passed by reference as the latter have value semantics.
+    template <typename Matrix>
+    KOKKOS_INLINE_FUNCTION static void jacobiSVD( Matrix &E, Matrix &U,
+                                                  Matrix &V )
     {
-        // TODO: This code (for getting A and pseudoA) can be updated later
-        // to work with offsets so that we can solve for matrices of
-        // different sizes. However, it is unclear what the best batched
-        // approach is. It could be that instead the matrices should be
-        // pre-sorted by size.
-        auto A = Kokkos::subview(
-            _As, Kokkos::make_pair( matrix_id * _n * _n,
-                                    ( matrix_id + 1 ) * _n * _n ) );
-        auto pseudoA = Kokkos::subview(
-            _pseudoAs, Kokkos::make_pair( matrix_id * _n * _n,
-                                          ( matrix_id + 1 ) * _n * _n ) );
+        auto const n = E.extent_int( 0 );
 
-        auto E = Kokkos::subview(
-            _aux, Kokkos::ALL(),
-            Kokkos::make_pair( 3 * matrix_id * _n, 3 * matrix_id * _n + _n ) );
-        auto U =
-            Kokkos::subview( _aux, Kokkos::ALL(),
-                             Kokkos::make_pair( 3 * matrix_id * _n + _n,
-                                                3 * matrix_id * _n + 2 * _n ) );
-        auto V =
-            Kokkos::subview( _aux, Kokkos::ALL(),
-                             Kokkos::make_pair( 3 * matrix_id * _n + 2 * _n,
-                                                3 * matrix_id * _n + 3 * _n ) );
-
-        for ( int i = 0; i < _n; i++ )
-            for ( int j = 0; j < _n; j++ )
-            {
-                E( i, j ) = A( i * _n + j );
-            }
-        for ( int i = 0; i < _n; i++ )
-            for ( int j = 0; j < _n; j++ )
+        for ( int i = 0; i < n; i++ )
+            for ( int j = 0; j < n; j++ )
             {
                 U( i, j ) = ( i == j ? 1.0 : 0.0 );
                 V( i, j ) = ( i == j ? 1.0 : 0.0 );
@@ -265,6 +248,43 @@ struct SVDFunctor
 
             norm = norm_F_wo_diag( E );
         }
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()( const int matrix_id, size_t &num_underdetermined ) const
+    {
+        // TODO: This code (for getting A and pseudoA) can be updated later
+        // to work with offsets so that we can solve for matrices of
+        // different sizes. However, it is unclear what the best batched
+        // approach is. It could be that instead the matrices should be
+        // pre-sorted by size.
+        auto A = Kokkos::subview(
+            _As, Kokkos::make_pair( matrix_id * _n * _n,
+                                    ( matrix_id + 1 ) * _n * _n ) );
+        auto pseudoA = Kokkos::subview(
+            _pseudoAs, Kokkos::make_pair( matrix_id * _n * _n,
+                                          ( matrix_id + 1 ) * _n * _n ) );
+
+        auto E = Kokkos::subview(
+            _aux, Kokkos::ALL(),
+            Kokkos::make_pair( 3 * matrix_id * _n, 3 * matrix_id * _n + _n ) );
+        auto U =
+            Kokkos::subview( _aux, Kokkos::ALL(),
+                             Kokkos::make_pair( 3 * matrix_id * _n + _n,
+                                                3 * matrix_id * _n + 2 * _n ) );
+        auto V =
+            Kokkos::subview( _aux, Kokkos::ALL(),
+                             Kokkos::make_pair( 3 * matrix_id * _n + 2 * _n,
+                                                3 * matrix_id * _n + 3 * _n ) );
+
+        for ( int i = 0; i < _n; i++ )
+            for ( int j = 0; j < _n; j++ )
+            {
+                E( i, j ) = A( i * _n + j );
+            }
+        jacobiSVD( E, U, V );
+
+        auto tol = KokkosExt::ArithmeticTraits::epsilon<double>::value;
 
         // Compute pseudo-inverse (pseudoA = V pseudoE U^T)
         // NOTE: the V stored above is actually V^T, but we don't explicitly
@@ -0,0 +1,212 @@
+/****************************************************************************
+ * Copyright (c) 2012-2019 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_SYMMETRIC_SOLVER_IMPL_HPP
+#define DTK_DETAILS_SYMMETRIC_SOLVER_IMPL_HPP
+
+#include <ArborX_DetailsKokkosExt.hpp> // ArithmeticTraits
+#include <DTK_DetailsSVDImpl.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+
+// Dense N x N matrix stored row-major in a Kokkos::Array. N is known at
+// compile time so that the matrix can be kept in registers.
+template <int N>
+struct SquareMatrix
+{
+    KOKKOS_INLINE_FUNCTION double &operator()( int i, int j )
+    {
+        return _data[i * N + j];
+    }
+
+    KOKKOS_INLINE_FUNCTION double const &operator()( int i, int j ) const
+    {
+        return _data[i * N + j];
+    }
+
+    KOKKOS_INLINE_FUNCTION constexpr int extent_int( int ) const { return N; }
+
+    Kokkos::Array<double, N * N> _data;
+};
+
+// Position of the entry (i, j), i <= j, of a symmetric n x n matrix whose
+// upper triangle is stored row by row.
+KOKKOS_INLINE_FUNCTION constexpr int packedIndex( int i, int j, int n )
+{
+    return i * n - i * ( i - 1 ) / 2 + j - i;
+}
+
+// Symmetric N x N matrix of which only the upper triangle is stored. The
+// matrices can be summed so that they can be the result of a reduction, e.g.
+// the sum of the rank-1 updates of the moment matrix over the neighbors.
+template <int N>
+struct PackedSymmetricMatrix
+{
+    static int constexpr size = N * ( N + 1 ) / 2;
+
+    KOKKOS_INLINE_FUNCTION PackedSymmetricMatrix()
+    {
+        for ( int i = 0; i < size; ++i )
+            _data[i] = 0.;
+    }
+
+    KOKKOS_INLINE_FUNCTION double operator()( int i, int j ) const
+    {
+        return i <= j ? _data[packedIndex( i, j, N )]
+                      : _data[packedIndex( j, i, N )];
+    }
+
+    // A += w p p^T
+    KOKKOS_INLINE_FUNCTION void
+    rankOneUpdate( double w, Kokkos::Array<double, N> const &p )
+    {
+        int ij = 0;
+        for ( int i = 0; i < N; ++i )
+        {
+            double const w_p_i = w * p[i];
+            for ( int j = i; j < N; ++j )
+                _data[ij++] += w_p_i * p[j];
+        }
+    }
+
+    KOKKOS_INLINE_FUNCTION PackedSymmetricMatrix &
+    operator+=( PackedSymmetricMatrix const &other )
+    {
+        for ( int i = 0; i < size; ++i )
+            _data[i] += other._data[i];
+        return *this;
+    }
+
+    KOKKOS_INLINE_FUNCTION void
+    operator+=( volatile PackedSymmetricMatrix const &other ) volatile
+    {
+        for ( int i = 0; i < size; ++i )
+            _data[i] += other._data[i];
+    }
+
+    double _data[size];
+};
+
+// Solver for the first row of the (pseudo-)inverse of a symmetric positive
+// semi-definite N x N matrix, such as the moment matrix of the moving least
+// squares.  The matrix is factorized as L D L^T and the row is obtained by
+// solving A x = e_0.  If a pivot of the factorization is not significantly
+// positive, the matrix is considered rank-deficient and the row of the
+// pseudo-inverse is computed using the SVD instead.
+template <typename DeviceType, int N>
+struct SymmetricSolver
+{
+    // Return true if the matrix was found to be rank-deficient, i.e. if the
+    // SVD was used.
+    KOKKOS_INLINE_FUNCTION static bool
+    firstRowOfInverse( SquareMatrix<N> const &a, Kokkos::Array<double, N> &x )
+    {
+        if ( ldlt( a, x ) )
+            return false;
+
+        pseudoInverse( a, x );
+        return true;
+    }
+
+    // Return false if the factorization broke down.
+    KOKKOS_INLINE_FUNCTION static bool ldlt( SquareMatrix<N> const &a,
+                                             Kokkos::Array<double, N> &x )
+    {
+        // A pivot is considered to vanish when it is small compared to the
+        // corresponding diagonal entry of A. The test is invariant under
+        // scaling of the basis functions. Falling back to the SVD for a matrix
+        // that is in fact invertible only costs time since the pseudo-inverse
+        // is then the inverse.
+        double const tol = std::sqrt(
+            KokkosExt::ArithmeticTraits::epsilon<double>::value );
+
+        SquareMatrix<N> l = a;
+        Kokkos::Array<double, N> d;
+        for ( int j = 0; j < N; ++j )
+        {
+            for ( int k = 0; k < j; ++k )
+                l( j, j ) -= l( j, k ) * l( j, k ) * d[k];
+            if ( !( l( j, j ) > tol * a( j, j ) ) )
+                return false;
+            d[j] = l( j, j );
+            for ( int i = j + 1; i < N; ++i )
+            {
+                for ( int k = 0; k < j; ++k )
+                    l( i, j ) -= l( i, k ) * l( j, k ) * d[k];
+                l( i, j ) /= d[j];
+            }
+        }
+
+        // Forward substitution L y = e_0 and scaling by D^{-1}
+        for ( int i = 0; i < N; ++i )
+        {
+            x[i] = ( i == 0 ? 1. : 0. );
+            for ( int k = 0; k < i; ++k )
+                x[i] -= l( i, k ) * x[k];
+        }
+        for ( int i = 0; i < N; ++i )
+            x[i] /= d[i];
+
+        // Backward substitution L^T x = D^{-1} y
+        for ( int i = N - 1; i >= 0; --i )
+            for ( int k = i + 1; k < N; ++k )
+                x[i] -= l( k, i ) * x[k];
+
+        return true;
+    }
+
+    KOKKOS_INLINE_FUNCTION static void
+    pseudoInverse( SquareMatrix<N> const &a, Kokkos::Array<double, N> &x )
+    {
+        SquareMatrix<N> e = a;
+        SquareMatrix<N> u;
+        SquareMatrix<N> v;
+        SVDFunctor<DeviceType>::jacobiSVD( e, u, v );
+
+        // Same as SVDFunctor, restricted to the first row (V is stored
+        // transposed).
+        double const tol = KokkosExt::ArithmeticTraits::epsilon<double>::value;
+        for ( int j = 0; j < N; ++j )
+        {
+            x[j] = 0.;
+            for ( int k = 0; k < N; ++k )
+                if ( std::abs( e( k, k ) ) >= tol )
+                    x[j] += v( k, 0 ) * u( j, k ) / e( k, k );
+        }
+    }
+};
+
+} // end namespace Details
+} // end namespace DataTransferKit
+
+namespace Kokkos
+{
+// Identity of the sum of PackedSymmetricMatrix, needed by the reductions.
+template <int N>
+struct reduction_identity<DataTransferKit::Details::PackedSymmetricMatrix<N>>
+{
+    KOKKOS_FORCEINLINE_FUNCTION static DataTransferKit::Details::
+        PackedSymmetricMatrix<N>
+        sum()
+    {
+        return DataTransferKit::Details::PackedSymmetricMatrix<N>();
+    }
+};
+} // namespace Kokkos
+
+#endif
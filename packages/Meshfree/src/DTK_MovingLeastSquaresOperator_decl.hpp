@@ -12,15 +12,43 @@
 #ifndef DTK_MOVING_LEAST_SQUARES_OPERATOR_DECL_HPP
 #define DTK_MOVING_LEAST_SQUARES_OPERATOR_DECL_HPP
 
+#include <ArborX.hpp>
 #include <DTK_CompactlySupportedRadialBasisFunctions.hpp>
+#include <DTK_DetailsDistributor.hpp>
 #include <DTK_MultivariatePolynomialBasis.hpp>
 #include <DTK_PointCloudOperator.hpp>
+#include <DTK_PointOrdering.hpp>
 
 #include <mpi.h>
 
+#include <limits>
+
 namespace DataTransferKit
 {
 
+// Precision in which the coefficients of the moving least squares operator
+// are stored. They are always computed in double precision. Storing them in
+// single precision halves their memory footprint, and the operator can still
+// be applied to double values.
+enum class CoefficientPrecision
+{
+    Double,
+    Single
+};
+
+// Support radius of the weights, the same for all the target points. It is a
+// distinct type so that a bare number given to the constructors of
+// MovingLeastSquaresOperator is always a number of neighbors.
+struct SupportRadius
+{
+    explicit SupportRadius( double r )
+        : value( r )
+    {
+    }
+    double value;
+};
+
+// The points have PolynomialBasis::dimension coordinates.
 template <typename DeviceType,
           typename CompactlySupportedRadialBasisFunction = Wendland<0>,
           typename PolynomialBasis = MultivariatePolynomialBasis<Linear, 3>>
@@ -29,22 +57,106 @@ class MovingLeastSquaresOperator : public PointCloudOperator<DeviceType>
     using ExecutionSpace = typename DeviceType::execution_space;
 
   public:
+    // Use the n_neighbors source points closest to each target point. Taking
+    // more neighbors than the size of the polynomial basis makes the moment
+    // matrices less likely to be rank-deficient. With PointOrdering::Morton,
+    // the neighbors of the target points are searched for along a Morton
+    // curve.
+    MovingLeastSquaresOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        unsigned int n_neighbors = PolynomialBasis::size,
+        PointOrdering ordering = PointOrdering::Caller,
+        CoefficientPrecision precision = CoefficientPrecision::Double );
+
+    // Use the source points within a support radius of each target point
+    // instead of the nearest neighbors, e.g. SupportRadius( 0.1 ). The target
+    // points with fewer than min_neighbors source points in their radius use
+    // their min_neighbors nearest neighbors instead, and only the
+    // max_neighbors closest source points are kept. The neighborhoods are
+    // unbounded by default. The setup falls back to the level-1 team scratch
+    // memory when the largest one does not fit in the level-0 scratch, and
+    // only throws if it does not fit in the level-1 scratch either.
     MovingLeastSquaresOperator(
         MPI_Comm comm,
         Kokkos::View<Coordinate const **, DeviceType> source_points,
-        Kokkos::View<Coordinate const **, DeviceType> target_points );
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        SupportRadius radius,
+        unsigned int min_neighbors = PolynomialBasis::size,
+        unsigned int max_neighbors = std::numeric_limits<int>::max(),
+        PointOrdering ordering = PointOrdering::Caller,
+        CoefficientPrecision precision = CoefficientPrecision::Double );
+
+    // Same as above with a radius for each target point.
+    MovingLeastSquaresOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        Kokkos::View<double const *, DeviceType> radius,
+        unsigned int min_neighbors = PolynomialBasis::size,
+        unsigned int max_neighbors = std::numeric_limits<int>::max(),
+        PointOrdering ordering = PointOrdering::Caller,
+        CoefficientPrecision precision = CoefficientPrecision::Double );
+
+    void apply( Kokkos::View<double const *, DeviceType> source_values,
+                Kokkos::View<double *, DeviceType> target_values ) override;
+
+    void apply( Kokkos::View<double const **, DeviceType> source_values,
+                Kokkos::View<double **, DeviceType> target_values ) override;
+
+    void apply( Kokkos::View<float const *, DeviceType> source_values,
+                Kokkos::View<float *, DeviceType> target_values ) override;
+
+    void apply( Kokkos::View<float const **, DeviceType> source_values,
+                Kokkos::View<float **, DeviceType> target_values ) override;
+
+    void applyBegin(
+        Kokkos::View<double const **, DeviceType> source_values,
+        Kokkos::View<double **, DeviceType> target_values ) override;
+
+    void applyEnd( Kokkos::View<double **, DeviceType> target_values ) override;
+
+    CrsMatrix<DeviceType> getCrsMatrix() const override;
+
+    void importSourceValues(
+        Kokkos::View<double const *, DeviceType> source_values,
+        Kokkos::View<double *, DeviceType> column_values ) override;
 
-    void
-    apply( Kokkos::View<double const *, DeviceType> source_values,
-           Kokkos::View<double *, DeviceType> target_values ) const override;
+    // Number of target points whose moment matrix was rank-deficient and
+    // was inverted with the SVD. The count is left on the device.
+    Kokkos::View<int const, DeviceType> getNumberOfIllConditionedTargets() const
+    {
+        return _n_ill_conditioned;
+    }
 
   private:
     MPI_Comm _comm;
     unsigned int const _n_source_points;
+    CoefficientPrecision const _precision;
     Kokkos::View<int *, DeviceType> _offset;
     Kokkos::View<int *, DeviceType> _ranks;
     Kokkos::View<int *, DeviceType> _indices;
+    // Only the coefficients in the precision chosen at construction are
+    // allocated.
     Kokkos::View<double *, DeviceType> _coeffs;
+    Kokkos::View<int, DeviceType> _n_ill_conditioned;
+    Kokkos::View<float *, DeviceType> _coeffs_float;
+    // Communication plan built once at construction and reused by apply().
+    Details::Distributor<DeviceType> _distributor;
+    Kokkos::View<int *, DeviceType> _export_source_indices;
+    Kokkos::View<int *, DeviceType> _import_target_indices;
+    Kokkos::View<double **, DeviceType> _import_values;
+    Kokkos::View<double **, DeviceType> _fetched_source_values;
+    // Distinct source points, which are the columns of the matrix returned
+    // by getCrsMatrix(), and the communication plan that imports their
+    // values. _columns is the column of each neighbor.
+    Kokkos::View<int *, DeviceType> _columns;
+    Kokkos::View<int *, DeviceType> _column_ranks;
+    Kokkos::View<int *, DeviceType> _column_indices;
+    Details::Distributor<DeviceType> _column_distributor;
+    Kokkos::View<int *, DeviceType> _column_export_source_indices;
+    Kokkos::View<int *, DeviceType> _column_import_target_indices;
 };
 
 } // end namespace DataTransferKit
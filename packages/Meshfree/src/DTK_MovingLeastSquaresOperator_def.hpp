@@ -16,6 +16,7 @@
 #include <DTK_DBC.hpp>
 #include <DTK_DetailsMovingLeastSquaresOperatorImpl.hpp>
 #include <DTK_DetailsNearestNeighborOperatorImpl.hpp> // fetch
+#include <DTK_PointOrdering.hpp>
 
 namespace DataTransferKit
 {
@@ -27,88 +28,236 @@ MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
     MovingLeastSquaresOperator(
         MPI_Comm comm,
         Kokkos::View<Coordinate const **, DeviceType> source_points,
-        Kokkos::View<Coordinate const **, DeviceType> target_points )
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        unsigned int n_neighbors, PointOrdering ordering,
+        CoefficientPrecision precision )
     : _comm( comm )
     , _n_source_points( source_points.extent( 0 ) )
+    , _precision( precision )
     , _offset( "offset" )
     , _ranks( "ranks" )
     , _indices( "indices" )
     , _coeffs( "polynomial_coefficients" )
+    , _n_ill_conditioned( "n_ill_conditioned" )
+    , _coeffs_float( "polynomial_coefficients" )
+    , _distributor( _comm )
+    , _export_source_indices( "source_indices" )
+    , _import_target_indices( "target_indices" )
+    , _import_values( "import_values" )
+    , _fetched_source_values( "fetched_source_values" )
+    , _columns( "columns" )
+    , _column_ranks( "column_ranks" )
+    , _column_indices( "column_indices" )
+    , _column_distributor( _comm )
+    , _column_export_source_indices( "source_indices" )
+    , _column_import_target_indices( "target_indices" )
 {
     DTK_REQUIRE( source_points.extent_int( 1 ) ==
                  target_points.extent_int( 1 ) );
-    // FIXME for now let's assume 3D
-    DTK_REQUIRE( source_points.extent_int( 1 ) == 3 );
+    DTK_REQUIRE( source_points.extent_int( 1 ) ==
+                 PolynomialBasis::dimension );
+    DTK_REQUIRE( n_neighbors >= PolynomialBasis::size );
 
     // Build distributed search tree over the source points.
-    ArborX::DistributedSearchTree<DeviceType> search_tree( _comm,
-                                                           source_points );
+    ArborX::DistributedSearchTree<DeviceType> search_tree(
+        _comm, Details::embedPoints( source_points ) );
     DTK_CHECK( !search_tree.empty() );
 
     // For each target point, query the n_neighbors points closest to the
     // target.
+    Kokkos::View<int *, DeviceType> permutation( "permutation", 0 );
+    Kokkos::View<Coordinate const **, DeviceType> query_points = target_points;
+    if ( ordering == PointOrdering::Morton )
+    {
+        permutation = Details::computeMortonPermutation( target_points );
+        query_points = Details::permuteRows( permutation, target_points );
+    }
     auto queries =
         Details::MovingLeastSquaresOperatorImpl<DeviceType>::makeKNNQueries(
-            target_points, PolynomialBasis::size );
+            query_points, n_neighbors );
 
     // Perform the actual search.
     search_tree.query( queries, _indices, _offset, _ranks );
+    if ( ordering == PointOrdering::Morton )
+        Details::restoreOrder( permutation, _offset, _indices, _ranks );
+
+    // Build the communication plan once so that apply() only has to pack,
+    // exchange, and unpack the values.
+    Details::NearestNeighborOperatorImpl<DeviceType>::setupCommunicationPlan(
+        _comm, _ranks, _indices, _distributor, _export_source_indices,
+        _import_target_indices );
 
     // Retrieve the coordinates of all source points that met the predicates.
     // NOTE: This is the last collective.
-    source_points = Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
-        _comm, _ranks, _indices, source_points );
-
-    // Transform source points
-    source_points = Details::MovingLeastSquaresOperatorImpl<
-        DeviceType>::transformSourceCoordinates( source_points, _offset,
-                                                 target_points );
-    target_points = Kokkos::View<double **, DeviceType>( "empty" );
-
-    // Build P (vandermonde matrix)
-    // P is a single 1D storage for multiple P_i matrices. Each matrix is of
-    // size (#source_points_for_specific_target_point, basis_size)
-    auto p =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeVandermonde(
-            source_points, PolynomialBasis() );
-
-    // To build the radial basis function, we need to define the radius of the
-    // radial basis function. Since we use kNN, we need to compute the radius.
-    // We only need the coordinates of the source points because of the
-    // transformation of the coordinates.
-    auto radius =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeRadius(
-            source_points, _offset );
-
-    // Build phi (weight matrix)
-    auto phi =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeWeights(
-            source_points, radius, CompactlySupportedRadialBasisFunction() );
-
-    // Build A (moment matrix)
-    auto a =
-        Details::MovingLeastSquaresOperatorImpl<DeviceType>::computeMoments(
-            _offset, p, phi );
-
-    // TODO: it is computationally unnecessary to compute the pseudo-inverse as
-    // MxM (U*E^+*V) as it will later be just used to do MxV. We could instead
-    // return the (U,E^+,V) and do the MxV multiplication. But for now, it's OK.
-    auto t = Details::MovingLeastSquaresOperatorImpl<DeviceType>::invertMoments(
-        a, PolynomialBasis::size );
-    auto inv_a = std::get<0>( t );
-
-    // std::get<1>(t) returns the number of undetermined system. However, this
-    // is not enough to know if we will lose order of accuracy. For example, if
-    // all the points are aligned, the system will be underdetermined. However
-    // this is not a problem if we found at least three points since this is
-    // enough to define a quadratic function. Therefore, not only we need to
-    // know the rank deficiency but also the dimension of the problem.
+    Kokkos::View<Coordinate **, DeviceType> fetched_source_points(
+        "fetched_source_points", _indices.extent( 0 ),
+        source_points.extent( 1 ) );
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_points, fetched_source_points );
+    source_points = fetched_source_points;
 
+    // The columns of the matrix returned by getCrsMatrix() are the distinct
+    // source points. Their values are imported with a plan of their own.
+    Details::NearestNeighborOperatorImpl<DeviceType>::makeColumnMap(
+        _ranks, _indices, _columns, _column_ranks, _column_indices );
+    Details::NearestNeighborOperatorImpl<DeviceType>::setupCommunicationPlan(
+        _comm, _column_ranks, _column_indices, _column_distributor,
+        _column_export_source_indices, _column_import_target_indices );
+
+    // Build the Vandermonde matrix, the weights, and the moment matrix of
+    // each neighborhood, and invert the moment matrix, in a single kernel. The
+    // intermediate matrices only live in team scratch memory.
     // NOTE: This assumes that the polynomial basis evaluated at {0,0,0} is
     // going to be [1, 0, 0, ..., 0]^T.
-    _coeffs = Details::MovingLeastSquaresOperatorImpl<
-        DeviceType>::computePolynomialCoefficients( _offset, inv_a, p, phi,
-                                                    PolynomialBasis::size );
+    _coeffs = Details::MovingLeastSquaresOperatorImpl<DeviceType>::
+        computePolynomialCoefficientsFused(
+            _offset, source_points, target_points,
+            CompactlySupportedRadialBasisFunction(), PolynomialBasis(),
+            Kokkos::View<double const *, DeviceType>(), _n_ill_conditioned );
+
+    // Only keep the coefficients in the precision requested.
+    if ( _precision == CoefficientPrecision::Single )
+    {
+        _coeffs_float = Details::MovingLeastSquaresOperatorImpl<
+            DeviceType>::template castValues<float>( _coeffs );
+        _coeffs = Kokkos::View<double *, DeviceType>();
+    }
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis>::
+    MovingLeastSquaresOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        SupportRadius radius, unsigned int min_neighbors,
+        unsigned int max_neighbors, PointOrdering ordering,
+        CoefficientPrecision precision )
+    : MovingLeastSquaresOperator(
+          comm, source_points, target_points,
+          Details::MovingLeastSquaresOperatorImpl<
+              DeviceType>::makeConstantRadius( target_points.extent( 0 ),
+                                               radius.value ),
+          min_neighbors, max_neighbors, ordering, precision )
+{
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis>::
+    MovingLeastSquaresOperator(
+        MPI_Comm comm,
+        Kokkos::View<Coordinate const **, DeviceType> source_points,
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        Kokkos::View<double const *, DeviceType> radius,
+        unsigned int min_neighbors, unsigned int max_neighbors,
+        PointOrdering ordering, CoefficientPrecision precision )
+    : _comm( comm )
+    , _n_source_points( source_points.extent( 0 ) )
+    , _precision( precision )
+    , _offset( "offset" )
+    , _ranks( "ranks" )
+    , _indices( "indices" )
+    , _coeffs( "polynomial_coefficients" )
+    , _n_ill_conditioned( "n_ill_conditioned" )
+    , _coeffs_float( "polynomial_coefficients" )
+    , _distributor( _comm )
+    , _export_source_indices( "source_indices" )
+    , _import_target_indices( "target_indices" )
+    , _import_values( "import_values" )
+    , _fetched_source_values( "fetched_source_values" )
+    , _columns( "columns" )
+    , _column_ranks( "column_ranks" )
+    , _column_indices( "column_indices" )
+    , _column_distributor( _comm )
+    , _column_export_source_indices( "source_indices" )
+    , _column_import_target_indices( "target_indices" )
+{
+    DTK_REQUIRE( source_points.extent_int( 1 ) ==
+                 target_points.extent_int( 1 ) );
+    DTK_REQUIRE( source_points.extent_int( 1 ) ==
+                 PolynomialBasis::dimension );
+    DTK_REQUIRE( radius.extent( 0 ) == target_points.extent( 0 ) );
+    DTK_REQUIRE( min_neighbors <= max_neighbors );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
+    // Build distributed search tree over the source points.
+    ArborX::DistributedSearchTree<DeviceType> search_tree(
+        _comm, Details::embedPoints( source_points ) );
+    DTK_CHECK( !search_tree.empty() );
+
+    // For each target point, query the source points within its radius.
+    if ( ordering == PointOrdering::Morton )
+    {
+        auto const permutation =
+            Details::computeMortonPermutation( target_points );
+        search_tree.query(
+            Impl::makeRadiusQueries(
+                Details::permuteRows( permutation, target_points ),
+                Details::permuteRows( permutation, radius ) ),
+            _indices, _offset, _ranks );
+        Details::restoreOrder( permutation, _offset, _indices, _ranks );
+    }
+    else
+        search_tree.query( Impl::makeRadiusQueries( target_points, radius ),
+                           _indices, _offset, _ranks );
+
+    // Fall back to the nearest neighbors for the target points that do not
+    // have enough source points within their radius.
+    Impl::addNearestNeighbors( _comm, search_tree, target_points,
+                               min_neighbors, _offset, _indices, _ranks );
+
+    Details::NearestNeighborOperatorImpl<DeviceType>::setupCommunicationPlan(
+        _comm, _ranks, _indices, _distributor, _export_source_indices,
+        _import_target_indices );
+
+    Kokkos::View<Coordinate **, DeviceType> fetched_source_points(
+        "fetched_source_points", _indices.extent( 0 ),
+        source_points.extent( 1 ) );
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_points, fetched_source_points );
+
+    // Only keep the closest source points when there are too many of them.
+    // The communication plan must then be rebuilt for the remaining ones.
+    int const removed_neighbors =
+        Impl::keepClosestNeighbors( target_points, max_neighbors, _offset,
+                                    _indices, _ranks, fetched_source_points )
+            ? 1
+            : 0;
+    int any_removed_neighbors = 0;
+    MPI_Allreduce( &removed_neighbors, &any_removed_neighbors, 1, MPI_INT,
+                   MPI_MAX, _comm );
+    if ( any_removed_neighbors )
+        Details::NearestNeighborOperatorImpl<DeviceType>::
+            setupCommunicationPlan( _comm, _ranks, _indices, _distributor,
+                                    _export_source_indices,
+                                    _import_target_indices );
+    source_points = fetched_source_points;
+
+    // The columns of the matrix returned by getCrsMatrix() are the distinct
+    // source points. Their values are imported with a plan of their own.
+    Details::NearestNeighborOperatorImpl<DeviceType>::makeColumnMap(
+        _ranks, _indices, _columns, _column_ranks, _column_indices );
+    Details::NearestNeighborOperatorImpl<DeviceType>::setupCommunicationPlan(
+        _comm, _column_ranks, _column_indices, _column_distributor,
+        _column_export_source_indices, _column_import_target_indices );
+
+    _coeffs = Impl::computePolynomialCoefficientsFused(
+        _offset, source_points, target_points,
+        CompactlySupportedRadialBasisFunction(), PolynomialBasis(), radius,
+        _n_ill_conditioned );
+
+    if ( _precision == CoefficientPrecision::Single )
+    {
+        _coeffs_float = Impl::template castValues<float>( _coeffs );
+        _coeffs = Kokkos::View<double *, DeviceType>();
+    }
 }
 
 template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
@@ -116,21 +265,204 @@ template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
 void MovingLeastSquaresOperator<
     DeviceType, CompactlySupportedRadialBasisFunction, PolynomialBasis>::
     apply( Kokkos::View<double const *, DeviceType> source_values,
-           Kokkos::View<double *, DeviceType> target_values ) const
+           Kokkos::View<double *, DeviceType> target_values )
 {
     // Precondition: check that the source and the target are properly sized
     DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
     DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
 
     // Retrieve values for all source points
-    source_values = Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
-        _comm, _ranks, _indices, source_values );
+    Kokkos::View<double *, DeviceType> fetched_source_values(
+        "fetched_source_values", _indices.extent( 0 ) );
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_values, fetched_source_values );
+    source_values = fetched_source_values;
 
     // Apply A-1 (P^T phi)
-    auto new_target_values = Details::MovingLeastSquaresOperatorImpl<
-        DeviceType>::computeTargetValues( _offset, _coeffs, source_values );
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    if ( _precision == CoefficientPrecision::Single )
+        Kokkos::deep_copy( target_values,
+                           Impl::template computeTargetValues<double, float>(
+                               _offset, _coeffs_float, source_values ) );
+    else
+        Kokkos::deep_copy( target_values,
+                           Impl::template computeTargetValues<double, double>(
+                               _offset, _coeffs, source_values ) );
+}
 
-    Kokkos::deep_copy( target_values, new_target_values );
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void MovingLeastSquaresOperator<
+    DeviceType, CompactlySupportedRadialBasisFunction, PolynomialBasis>::
+    apply( Kokkos::View<double const **, DeviceType> source_values,
+           Kokkos::View<double **, DeviceType> target_values )
+{
+    applyBegin( source_values, target_values );
+    applyEnd( target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void MovingLeastSquaresOperator<
+    DeviceType, CompactlySupportedRadialBasisFunction, PolynomialBasis>::
+    apply( Kokkos::View<float const *, DeviceType> source_values,
+           Kokkos::View<float *, DeviceType> target_values )
+{
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+
+    Kokkos::View<float *, DeviceType> fetched_source_values(
+        "fetched_source_values", _indices.extent( 0 ) );
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_values, fetched_source_values );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    if ( _precision == CoefficientPrecision::Single )
+        Kokkos::deep_copy(
+            target_values,
+            Impl::template computeTargetValues<float, float>(
+                _offset, _coeffs_float, fetched_source_values ) );
+    else
+        Kokkos::deep_copy(
+            target_values,
+            Impl::template computeTargetValues<float, double>(
+                _offset, _coeffs, fetched_source_values ) );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void MovingLeastSquaresOperator<
+    DeviceType, CompactlySupportedRadialBasisFunction, PolynomialBasis>::
+    apply( Kokkos::View<float const **, DeviceType> source_values,
+           Kokkos::View<float **, DeviceType> target_values )
+{
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    Kokkos::View<float **, DeviceType> fetched_source_values(
+        "fetched_source_values", _indices.extent( 0 ),
+        source_values.extent( 1 ) );
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_values, fetched_source_values );
+
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    if ( _precision == CoefficientPrecision::Single )
+        Impl::template computeTargetValues<float, float>(
+            _offset, _coeffs_float, fetched_source_values, target_values );
+    else
+        Impl::template computeTargetValues<float, double>(
+            _offset, _coeffs, fetched_source_values, target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void MovingLeastSquaresOperator<
+    DeviceType, CompactlySupportedRadialBasisFunction, PolynomialBasis>::
+    applyBegin( Kokkos::View<double const **, DeviceType> source_values,
+                Kokkos::View<double **, DeviceType> target_values )
+{
+    // Precondition: check that the source and the target are properly sized
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    // The buffers are kept until applyEnd()
+    unsigned int const n_components = source_values.extent( 1 );
+    if ( _fetched_source_values.extent( 0 ) != _indices.extent( 0 ) ||
+         _fetched_source_values.extent( 1 ) != n_components )
+    {
+        _import_values = Kokkos::View<double **, DeviceType>(
+            "import_values", _import_target_indices.extent( 0 ),
+            n_components );
+        _fetched_source_values = Kokkos::View<double **, DeviceType>(
+            "fetched_source_values", _indices.extent( 0 ), n_components );
+    }
+
+    // Post the exchange of all the components of the values at once. The
+    // values owned by this rank are available right away so their
+    // contributions are computed while the other values are in flight.
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetchBegin(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_values, _import_values, _fetched_source_values );
+
+    int comm_rank;
+    MPI_Comm_rank( _comm, &comm_rank );
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    if ( _precision == CoefficientPrecision::Single )
+        Impl::template computePartialTargetValues<float>(
+            _offset, _coeffs_float, _ranks, comm_rank, true,
+            _fetched_source_values, target_values );
+    else
+        Impl::template computePartialTargetValues<double>(
+            _offset, _coeffs, _ranks, comm_rank, true, _fetched_source_values,
+            target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void MovingLeastSquaresOperator<
+    DeviceType, CompactlySupportedRadialBasisFunction, PolynomialBasis>::
+    applyEnd( Kokkos::View<double **, DeviceType> target_values )
+{
+    DTK_REQUIRE( target_values.extent( 0 ) == _offset.extent( 0 ) - 1 );
+    DTK_REQUIRE( _fetched_source_values.extent( 1 ) ==
+                 target_values.extent( 1 ) );
+
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetchEnd(
+        _distributor, _import_target_indices, _import_values,
+        _fetched_source_values );
+
+    int comm_rank;
+    MPI_Comm_rank( _comm, &comm_rank );
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+    if ( _precision == CoefficientPrecision::Single )
+        Impl::template computePartialTargetValues<float>(
+            _offset, _coeffs_float, _ranks, comm_rank, false,
+            _fetched_source_values, target_values );
+    else
+        Impl::template computePartialTargetValues<double>(
+            _offset, _coeffs, _ranks, comm_rank, false, _fetched_source_values,
+            target_values );
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+CrsMatrix<DeviceType>
+MovingLeastSquaresOperator<DeviceType, CompactlySupportedRadialBasisFunction,
+                           PolynomialBasis>::getCrsMatrix() const
+{
+    // The rows are the neighborhoods of the target points and the columns
+    // are the distinct source points, which may be in several neighborhoods.
+    CrsMatrix<DeviceType> matrix;
+    matrix.row_map = _offset;
+    matrix.entries = _columns;
+    matrix.values =
+        _precision == CoefficientPrecision::Single
+            ? Details::MovingLeastSquaresOperatorImpl<
+                  DeviceType>::template castValues<double>( _coeffs_float )
+            : _coeffs;
+    matrix.column_ranks = _column_ranks;
+    matrix.column_indices = _column_indices;
+    return matrix;
+}
+
+template <typename DeviceType, typename CompactlySupportedRadialBasisFunction,
+          typename PolynomialBasis>
+void MovingLeastSquaresOperator<
+    DeviceType, CompactlySupportedRadialBasisFunction, PolynomialBasis>::
+    importSourceValues( Kokkos::View<double const *, DeviceType> source_values,
+                        Kokkos::View<double *, DeviceType> column_values )
+{
+    DTK_REQUIRE( source_values.extent( 0 ) == _n_source_points );
+    DTK_REQUIRE( column_values.extent( 0 ) == _column_indices.extent( 0 ) );
+
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _column_distributor, _column_export_source_indices,
+        _column_import_target_indices, source_values, column_values );
 }
 
 } // end namespace DataTransferKit
@@ -140,6 +472,12 @@ void MovingLeastSquaresOperator<
     template class MovingLeastSquaresOperator<typename NODE::device_type>;     \
     template class MovingLeastSquaresOperator<                                 \
         typename NODE::device_type, Wendland<0>,                               \
-        MultivariatePolynomialBasis<Quadratic, 3>>;
+        MultivariatePolynomialBasis<Quadratic, 3>>;                            \
+    template class MovingLeastSquaresOperator<                                 \
+        typename NODE::device_type, Wendland<0>,                               \
+        MultivariatePolynomialBasis<Linear, 2>>;                               \
+    template class MovingLeastSquaresOperator<                                 \
+        typename NODE::device_type, Wendland<0>,                               \
+        MultivariatePolynomialBasis<Quadratic, 2>>;
 
 #endif
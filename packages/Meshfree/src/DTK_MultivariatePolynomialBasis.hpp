@@ -79,6 +79,7 @@ struct Size<Quadratic, 2>
 template <typename Basis, int DIM>
 struct MultivariatePolynomialBasis
 {
+    static int constexpr dimension = DIM;
     static int constexpr size = Details::Size<Basis, DIM>::value;
 
     template <typename Point>
@@ -89,6 +90,8 @@ struct MultivariatePolynomialBasis
 // Definition below is required (until C++17) to avoid link-time errors
 // c.f. https://en.cppreference.com/w/cpp/language/definition#ODR-use
 template <typename Basis, int DIM>
+int constexpr MultivariatePolynomialBasis<Basis, DIM>::dimension;
+template <typename Basis, int DIM>
 int constexpr MultivariatePolynomialBasis<Basis, DIM>::size;
 
 // NOTE: For now relying on Point::operator[]( int i ) to access the coordinates
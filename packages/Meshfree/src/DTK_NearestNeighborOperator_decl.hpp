@@ -12,14 +12,19 @@
 #ifndef DTK_NEAREST_NEIGHBOR_OPERATOR_DECL_HPP
 #define DTK_NEAREST_NEIGHBOR_OPERATOR_DECL_HPP
 
+#include <ArborX.hpp>
+#include <DTK_DetailsDistributor.hpp>
 #include <DTK_PointCloudOperator.hpp>
+#include <DTK_PointOrdering.hpp>
 
 #include <mpi.h>
 
 namespace DataTransferKit
 {
 
-template <typename DeviceType>
+// The points have DIM coordinates. With PointOrdering::Morton, the nearest
+// neighbors of the target points are searched for along a Morton curve.
+template <typename DeviceType, int DIM = 3>
 class NearestNeighborOperator : public PointCloudOperator<DeviceType>
 {
     using ExecutionSpace = typename DeviceType::execution_space;
@@ -28,17 +33,52 @@ class NearestNeighborOperator : public PointCloudOperator<DeviceType>
     NearestNeighborOperator(
         MPI_Comm comm,
         Kokkos::View<Coordinate const **, DeviceType> source_points,
-        Kokkos::View<Coordinate const **, DeviceType> target_points );
+        Kokkos::View<Coordinate const **, DeviceType> target_points,
+        PointOrdering ordering = PointOrdering::Caller );
 
-    void
-    apply( Kokkos::View<double const *, DeviceType> source_values,
-           Kokkos::View<double *, DeviceType> target_values ) const override;
+    void apply( Kokkos::View<double const *, DeviceType> source_values,
+                Kokkos::View<double *, DeviceType> target_values ) override;
+
+    void apply( Kokkos::View<double const **, DeviceType> source_values,
+                Kokkos::View<double **, DeviceType> target_values ) override;
+
+    void apply( Kokkos::View<float const *, DeviceType> source_values,
+                Kokkos::View<float *, DeviceType> target_values ) override;
+
+    void apply( Kokkos::View<float const **, DeviceType> source_values,
+                Kokkos::View<float **, DeviceType> target_values ) override;
+
+    void applyBegin(
+        Kokkos::View<double const **, DeviceType> source_values,
+        Kokkos::View<double **, DeviceType> target_values ) override;
+
+    void applyEnd( Kokkos::View<double **, DeviceType> target_values ) override;
+
+    CrsMatrix<DeviceType> getCrsMatrix() const override;
+
+    void importSourceValues(
+        Kokkos::View<double const *, DeviceType> source_values,
+        Kokkos::View<double *, DeviceType> column_values ) override;
 
   private:
     MPI_Comm _comm;
     Kokkos::View<int *, DeviceType> _indices;
     Kokkos::View<int *, DeviceType> _ranks;
     int const _size;
+    // Communication plan built once at construction and reused by apply().
+    Details::Distributor<DeviceType> _distributor;
+    Kokkos::View<int *, DeviceType> _export_source_indices;
+    Kokkos::View<int *, DeviceType> _import_target_indices;
+    Kokkos::View<double **, DeviceType> _import_values;
+    // Distinct source points, which are the columns of the matrix returned
+    // by getCrsMatrix(), and the communication plan that imports their
+    // values. _columns is the column of each neighbor.
+    Kokkos::View<int *, DeviceType> _columns;
+    Kokkos::View<int *, DeviceType> _column_ranks;
+    Kokkos::View<int *, DeviceType> _column_indices;
+    Details::Distributor<DeviceType> _column_distributor;
+    Kokkos::View<int *, DeviceType> _column_export_source_indices;
+    Kokkos::View<int *, DeviceType> _column_import_target_indices;
 };
 
 } // namespace DataTransferKit
@@ -15,40 +15,66 @@
 #include <ArborX.hpp>
 #include <DTK_DBC.hpp>
 #include <DTK_DetailsNearestNeighborOperatorImpl.hpp>
+#include <DTK_PointOrdering.hpp>
 
 namespace DataTransferKit
 {
 
-template <typename DeviceType>
-NearestNeighborOperator<DeviceType>::NearestNeighborOperator(
+template <typename DeviceType, int DIM>
+NearestNeighborOperator<DeviceType, DIM>::NearestNeighborOperator(
     MPI_Comm comm, Kokkos::View<Coordinate const **, DeviceType> source_points,
-    Kokkos::View<Coordinate const **, DeviceType> target_points )
+    Kokkos::View<Coordinate const **, DeviceType> target_points,
+    PointOrdering ordering )
     : _comm( comm )
     , _indices( "indices" )
     , _ranks( "ranks" )
     , _size( source_points.extent_int( 0 ) )
+    , _distributor( _comm )
+    , _export_source_indices( "source_indices" )
+    , _import_target_indices( "target_indices" )
+    , _import_values( "import_values" )
+    , _columns( "columns" )
+    , _column_ranks( "column_ranks" )
+    , _column_indices( "column_indices" )
+    , _column_distributor( _comm )
+    , _column_export_source_indices( "source_indices" )
+    , _column_import_target_indices( "target_indices" )
 {
+    // The ranks without any source point may pass an unallocated view.
+    DTK_REQUIRE( source_points.extent( 0 ) == 0 ||
+                 source_points.extent_int( 1 ) == DIM );
+    DTK_REQUIRE( target_points.extent_int( 1 ) == DIM );
+
     // NOTE: instead of checking the pre-condition that there is at least one
     // source point passed to one of the rank, we let the tree handle the
     // communication and just check that the tree is not empty.
 
     // Build distributed search tree over the source points.
-    ArborX::DistributedSearchTree<DeviceType> search_tree( _comm,
-                                                           source_points );
+    ArborX::DistributedSearchTree<DeviceType> search_tree(
+        _comm, Details::embedPoints( source_points ) );
 
     // Tree must have at least one leaf, otherwise it makes little sense to
     // perform the search for nearest neighbors.
     DTK_CHECK( !search_tree.empty() );
 
     // Query nearest neighbor for all target points.
+    Kokkos::View<int *, DeviceType> permutation( "permutation", 0 );
+    Kokkos::View<Coordinate const **, DeviceType> query_points = target_points;
+    if ( ordering == PointOrdering::Morton )
+    {
+        permutation = Details::computeMortonPermutation( target_points );
+        query_points = Details::permuteRows( permutation, target_points );
+    }
     auto nearest_queries = Details::NearestNeighborOperatorImpl<
-        DeviceType>::makeNearestNeighborQueries( target_points );
+        DeviceType>::makeNearestNeighborQueries( query_points );
 
     // Perform the actual search.
     Kokkos::View<int *, DeviceType> indices( "indices" );
     Kokkos::View<int *, DeviceType> offset( "offset" );
     Kokkos::View<int *, DeviceType> ranks( "ranks" );
     search_tree.query( nearest_queries, indices, offset, ranks );
+    if ( ordering == PointOrdering::Morton )
+        Details::restoreOrder( permutation, offset, indices, ranks );
 
     // Check post-condition that we did find a nearest neighbor to all target
     // points.
@@ -60,27 +86,147 @@ NearestNeighborOperator<DeviceType>::NearestNeighborOperator(
     // ..., n_target_poins]`
     _indices = indices;
     _ranks = ranks;
+
+    // Build the communication plan once so that apply() only has to pack,
+    // exchange, and unpack the values.
+    Details::NearestNeighborOperatorImpl<DeviceType>::setupCommunicationPlan(
+        _comm, _ranks, _indices, _distributor, _export_source_indices,
+        _import_target_indices );
+
+    // The columns of the matrix returned by getCrsMatrix() are the distinct
+    // source points. Their values are imported with a plan of their own.
+    Details::NearestNeighborOperatorImpl<DeviceType>::makeColumnMap(
+        _ranks, _indices, _columns, _column_ranks, _column_indices );
+    Details::NearestNeighborOperatorImpl<DeviceType>::setupCommunicationPlan(
+        _comm, _column_ranks, _column_indices, _column_distributor,
+        _column_export_source_indices, _column_import_target_indices );
 }
 
-template <typename DeviceType>
-void NearestNeighborOperator<DeviceType>::apply(
+template <typename DeviceType, int DIM>
+void NearestNeighborOperator<DeviceType, DIM>::apply(
     Kokkos::View<double const *, DeviceType> source_values,
-    Kokkos::View<double *, DeviceType> target_values ) const
+    Kokkos::View<double *, DeviceType> target_values )
+{
+    // Precondition: check that the source and target are properly sized
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+
+    // The nearest neighbor operator is a permutation so the values are
+    // directly unpacked into the output.
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_values, target_values );
+}
+
+template <typename DeviceType, int DIM>
+void NearestNeighborOperator<DeviceType, DIM>::apply(
+    Kokkos::View<double const **, DeviceType> source_values,
+    Kokkos::View<double **, DeviceType> target_values )
+{
+    applyBegin( source_values, target_values );
+    applyEnd( target_values );
+}
+
+template <typename DeviceType, int DIM>
+void NearestNeighborOperator<DeviceType, DIM>::apply(
+    Kokkos::View<float const *, DeviceType> source_values,
+    Kokkos::View<float *, DeviceType> target_values )
+{
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_values, target_values );
+}
+
+template <typename DeviceType, int DIM>
+void NearestNeighborOperator<DeviceType, DIM>::apply(
+    Kokkos::View<float const **, DeviceType> source_values,
+    Kokkos::View<float **, DeviceType> target_values )
+{
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_values, target_values );
+}
+
+template <typename DeviceType, int DIM>
+void NearestNeighborOperator<DeviceType, DIM>::applyBegin(
+    Kokkos::View<double const **, DeviceType> source_values,
+    Kokkos::View<double **, DeviceType> target_values )
 {
     // Precondition: check that the source and target are properly sized
     DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
     DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+    DTK_REQUIRE( source_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    // The buffer receiving the values is kept until applyEnd()
+    if ( _import_values.extent( 0 ) != _import_target_indices.extent( 0 ) ||
+         _import_values.extent( 1 ) != source_values.extent( 1 ) )
+        _import_values = Kokkos::View<double **, DeviceType>(
+            "import_values", _import_target_indices.extent( 0 ),
+            source_values.extent( 1 ) );
+
+    // The targets whose nearest neighbor is owned by this rank are set right
+    // away.
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetchBegin(
+        _distributor, _export_source_indices, _import_target_indices,
+        source_values, _import_values, target_values );
+}
+
+template <typename DeviceType, int DIM>
+void NearestNeighborOperator<DeviceType, DIM>::applyEnd(
+    Kokkos::View<double **, DeviceType> target_values )
+{
+    DTK_REQUIRE( _indices.extent( 0 ) == target_values.extent( 0 ) );
+    DTK_REQUIRE( _import_values.extent( 1 ) == target_values.extent( 1 ) );
+
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetchEnd(
+        _distributor, _import_target_indices, _import_values, target_values );
+}
 
-    auto values = Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
-        _comm, _ranks, _indices, source_values );
+template <typename DeviceType, int DIM>
+CrsMatrix<DeviceType>
+NearestNeighborOperator<DeviceType, DIM>::getCrsMatrix() const
+{
+    // The matrix has a single unit entry per row, in the column of the
+    // nearest neighbor of the target point.
+    auto const n_target_points = _indices.extent( 0 );
+    CrsMatrix<DeviceType> matrix;
+    matrix.row_map =
+        Kokkos::View<int *, DeviceType>( "row_map", n_target_points + 1 );
+    ArborX::iota( matrix.row_map );
+    matrix.entries = _columns;
+    matrix.values =
+        Kokkos::View<double *, DeviceType>( "values", n_target_points );
+    Kokkos::deep_copy( matrix.values, 1. );
+    matrix.column_ranks = _column_ranks;
+    matrix.column_indices = _column_indices;
+    return matrix;
+}
+
+template <typename DeviceType, int DIM>
+void NearestNeighborOperator<DeviceType, DIM>::importSourceValues(
+    Kokkos::View<double const *, DeviceType> source_values,
+    Kokkos::View<double *, DeviceType> column_values )
+{
+    DTK_REQUIRE( _size == source_values.extent_int( 0 ) );
+    DTK_REQUIRE( _column_indices.extent( 0 ) == column_values.extent( 0 ) );
 
-    Kokkos::deep_copy( target_values, values );
+    Details::NearestNeighborOperatorImpl<DeviceType>::fetch(
+        _column_distributor, _column_export_source_indices,
+        _column_import_target_indices, source_values, column_values );
 }
 
 } // namespace DataTransferKit
 
 // Explicit instantiation macro
 #define DTK_NEARESTNEIGHBOROPERATOR_INSTANT( NODE )                            \
-    template class NearestNeighborOperator<typename NODE::device_type>;
+    template class NearestNeighborOperator<typename NODE::device_type>;        \
+    template class NearestNeighborOperator<typename NODE::device_type, 2>;
 
 #endif
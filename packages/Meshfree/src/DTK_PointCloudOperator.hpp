@@ -13,12 +13,17 @@
 #define DTK_POINT_CLOUD_OPERATOR_DECL_HPP
 
 #include <DTK_ConfigDefs.hpp>
+#include <DTK_CrsMatrix.hpp>
 
 #include <Kokkos_View.hpp>
 
 namespace DataTransferKit
 {
 
+// The operators own the communication plan and the buffers through which the
+// source values are exchanged, so applying one modifies it. An operator has
+// at most one exchange pending: between applyBegin() and applyEnd(), it must
+// not be applied again. Use distinct operators to overlap exchanges.
 template <typename DeviceType>
 class PointCloudOperator
 {
@@ -27,7 +32,63 @@ class PointCloudOperator
 
     virtual void
     apply( Kokkos::View<double const *, DeviceType> source_values,
-           Kokkos::View<double *, DeviceType> target_values ) const = 0;
+           Kokkos::View<double *, DeviceType> target_values ) = 0;
+
+    // Multi-field version: the second dimension of the views is the number of
+    // components, and all the components are communicated together.
+    virtual void
+    apply( Kokkos::View<double const **, DeviceType> source_values,
+           Kokkos::View<double **, DeviceType> target_values ) = 0;
+
+    // Single precision versions. The operator is still set up in double
+    // precision but the values communicated are in single precision, and so
+    // are the coefficients of the operator when it has some.
+    virtual void
+    apply( Kokkos::View<float const *, DeviceType> source_values,
+           Kokkos::View<float *, DeviceType> target_values ) = 0;
+
+    virtual void
+    apply( Kokkos::View<float const **, DeviceType> source_values,
+           Kokkos::View<float **, DeviceType> target_values ) = 0;
+
+    // Split version of the multi-field apply(). applyBegin() posts the
+    // exchange of the source values and computes what only depends on the
+    // source values owned by this rank. applyEnd() waits for the other values
+    // and completes target_values. In between, the source values must not be
+    // modified and target_values must not be used.
+    virtual void
+    applyBegin( Kokkos::View<double const **, DeviceType> source_values,
+                Kokkos::View<double **, DeviceType> target_values ) = 0;
+
+    virtual void
+    applyEnd( Kokkos::View<double **, DeviceType> target_values ) = 0;
+
+    // Export the operator as a sparse matrix. Applying the operator amounts to
+    // importing the source values into the column space of the matrix and
+    // multiplying by the matrix. The views may share their memory with the
+    // operator and must not be modified.
+    virtual CrsMatrix<DeviceType> getCrsMatrix() const = 0;
+
+    // Halo exchange: fetch the source values into the column space of the
+    // matrix returned by getCrsMatrix().
+    virtual void importSourceValues(
+        Kokkos::View<double const *, DeviceType> source_values,
+        Kokkos::View<double *, DeviceType> column_values ) = 0;
+
+    // Apply the operator as a halo exchange followed by a sparse matrix-vector
+    // product with a matrix obtained from getCrsMatrix().
+    void
+    applyCrsMatrix( CrsMatrix<DeviceType> const &matrix,
+                    Kokkos::View<double const *, DeviceType> source_values,
+                    Kokkos::View<double *, DeviceType> target_values )
+    {
+        Kokkos::View<double *, DeviceType> column_values(
+            "column_values", matrix.column_ranks.extent( 0 ) );
+        importSourceValues( source_values, column_values );
+        multiply( matrix, Kokkos::View<double const *, DeviceType>(
+                              column_values ),
+                  target_values );
+    }
 };
 
 } // end namespace DataTransferKit
@@ -10,6 +10,7 @@
  ****************************************************************************/
 
 #include <ArborX.hpp>
+#include <DTK_DetailsDistributor.hpp>
 #include <DTK_DetailsNearestNeighborOperatorImpl.hpp> // fetch
 
 #include <Teuchos_Array.hpp>
@@ -163,6 +164,62 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsDistributedSearchTreeImpl,
                                                 success, out );
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsDistributor, posts_and_waits,
+                                   DeviceType )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+
+    // send row i to rank i % comm_size
+    // receive 2 rows from each rank, sorted by rank
+    int const n = 2 * comm_size;
+    Kokkos::View<int *, DeviceType> ranks( "ranks", n );
+    Kokkos::View<int **, DeviceType> v_exp( "v_exp", n, 2 );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+                          KOKKOS_LAMBDA( int i ) {
+                              ranks( i ) = i % comm_size;
+                              v_exp( i, 0 ) = comm_rank * n + i;
+                              v_exp( i, 1 ) = -i;
+                          } );
+    Kokkos::fence();
+
+    Kokkos::View<int **, DeviceType> v_ref( "v_ref", n, 2 );
+    Kokkos::parallel_for( Kokkos::RangePolicy<ExecutionSpace>( 0, n ),
+                          KOKKOS_LAMBDA( int i ) {
+                              int const k = comm_rank + ( i % 2 ) * comm_size;
+                              v_ref( i, 0 ) = ( i / 2 ) * n + k;
+                              v_ref( i, 1 ) = -k;
+                          } );
+    Kokkos::fence();
+
+    DataTransferKit::Details::Distributor<DeviceType> distributor( comm );
+    TEST_EQUALITY( distributor.createFromSends( ranks ), n );
+    TEST_EQUALITY( distributor.getSelfReceiveRange().first, 2 * comm_rank );
+    TEST_EQUALITY( distributor.getSelfReceiveRange().second,
+                   2 * comm_rank + 2 );
+
+    Kokkos::View<int **, DeviceType> v_imp( "v_imp", n, 2 );
+    distributor.doPosts( v_exp, v_imp );
+    // The exported values can be modified before the communication ends
+    Kokkos::deep_copy( v_exp, 0 );
+    distributor.doWaits( v_imp );
+
+    TEST_COMPARE_ARRAYS( toArray( v_imp ), toArray( v_ref ) );
+
+    // The plan can be reused
+    Kokkos::View<int *, DeviceType> w_imp( "w_imp", n );
+    distributor.doPostsAndWaits( ranks, w_imp );
+    auto w_imp_host = Kokkos::create_mirror_view( w_imp );
+    Kokkos::deep_copy( w_imp_host, w_imp );
+    for ( int i = 0; i < n; ++i )
+        TEST_EQUALITY( w_imp_host( i ), comm_rank );
+}
+
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsNearestNeighborOperatorImpl, fetch,
                                    DeviceType )
 {
@@ -228,6 +285,8 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( DetailsNearestNeighborOperatorImpl, fetch,
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsDistributedSearchTreeImpl,    \
                                           send_across_network,                 \
                                           DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsDistributor, posts_and_waits, \
+                                          DeviceType##NODE )                   \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( DetailsNearestNeighborOperatorImpl,  \
                                           fetch, DeviceType##NODE )
 
@@ -18,6 +18,7 @@
 
 #include <array>
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <random>
@@ -276,6 +277,50 @@ TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator, grid, DeviceType,
     Kokkos::deep_copy( target_values_host, target_values );
     TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
                                   1e-11 );
+
+    // Apply the operator as a halo exchange followed by a sparse
+    // matrix-vector product and check that it gives the same result.
+    auto const matrix = mlsop.getCrsMatrix();
+    TEST_EQUALITY( matrix.row_map.extent( 0 ), n_target_points + 1 );
+    Kokkos::View<double *, DeviceType> crs_target_values( "target_values",
+                                                          n_target_points );
+    mlsop.applyCrsMatrix( matrix, source_values, crs_target_values );
+    auto crs_target_values_host =
+        Kokkos::create_mirror_view( crs_target_values );
+    Kokkos::deep_copy( crs_target_values_host, crs_target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( crs_target_values_host, target_values_host,
+                                  1e-14 );
+
+    // On a single rank, all the source points are in the plane z = 0 so the
+    // moment matrix is rank-deficient unless the basis is constant.
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+    auto n_ill_conditioned_host =
+        Kokkos::create_mirror_view( mlsop.getNumberOfIllConditionedTargets() );
+    Kokkos::deep_copy( n_ill_conditioned_host,
+                       mlsop.getNumberOfIllConditionedTargets() );
+    if ( PolynomialBasis::size == 1 )
+        TEST_EQUALITY( n_ill_conditioned_host(), 0 );
+    else if ( comm_size == 1 )
+        TEST_EQUALITY( n_ill_conditioned_host(), (int)n_target_points );
+
+    // Oversampling does not change the result for a polynomial of the order
+    // of the basis. A plain int is a number of neighbors, not a support
+    // radius.
+    int const n_neighbors = 2 * PolynomialBasis::size;
+    DataTransferKit::MovingLeastSquaresOperator<DeviceType, RadialBasisFunction,
+                                                PolynomialBasis>
+        oversampled_mlsop( comm, source_points, target_points, n_neighbors );
+    oversampled_mlsop.apply( source_values, target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
+                                  1e-10 );
+    auto const oversampled_row_map = oversampled_mlsop.getCrsMatrix().row_map;
+    auto oversampled_row_map_host =
+        Kokkos::create_mirror_view( oversampled_row_map );
+    Kokkos::deep_copy( oversampled_row_map_host, oversampled_row_map );
+    TEST_EQUALITY( oversampled_row_map_host( n_target_points ),
+                   static_cast<int>( n_target_points ) * n_neighbors );
 }
 
 TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator, line, DeviceType,
@@ -346,6 +391,96 @@ TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator, line, DeviceType,
     Kokkos::deep_copy( target_values_host, target_values );
     TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
                                   1e-11 );
+
+    // Transfer two fields at once: the function and its opposite.
+    Kokkos::View<double **, DeviceType> multi_source_values(
+        "multi_source_values", n_source_points, 2 );
+    auto multi_source_values_host =
+        Kokkos::create_mirror_view( multi_source_values );
+    for ( unsigned int i = 0; i < n_source_points; ++i )
+    {
+        multi_source_values_host( i, 0 ) = source_values_arr[i];
+        multi_source_values_host( i, 1 ) = -source_values_arr[i];
+    }
+    Kokkos::deep_copy( multi_source_values, multi_source_values_host );
+    Kokkos::View<double **, DeviceType> multi_target_values(
+        "multi_target_values", n_target_points, 2 );
+    mlsop.apply( multi_source_values, multi_target_values );
+
+    auto multi_target_values_host =
+        Kokkos::create_mirror_view( multi_target_values );
+    Kokkos::deep_copy( multi_target_values_host, multi_target_values );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+    {
+        TEST_FLOATING_EQUALITY( multi_target_values_host( i, 0 ),
+                                target_values_host( i ), 1e-14 );
+        TEST_FLOATING_EQUALITY( multi_target_values_host( i, 1 ),
+                                -target_values_host( i ), 1e-14 );
+    }
+
+    // Split the application to overlap the communication with other work.
+    Kokkos::View<double **, DeviceType> split_target_values(
+        "split_target_values", n_target_points, 2 );
+    mlsop.applyBegin( multi_source_values, split_target_values );
+    mlsop.applyEnd( split_target_values );
+
+    auto split_target_values_host =
+        Kokkos::create_mirror_view( split_target_values );
+    Kokkos::deep_copy( split_target_values_host, split_target_values );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+        for ( unsigned int k = 0; k < 2; ++k )
+            TEST_FLOATING_EQUALITY( split_target_values_host( i, k ),
+                                    multi_target_values_host( i, k ), 1e-14 );
+
+    // Transfer the fields in single precision.
+    Kokkos::View<float **, DeviceType> float_source_values(
+        "float_source_values", n_source_points, 2 );
+    auto float_source_values_host =
+        Kokkos::create_mirror_view( float_source_values );
+    for ( unsigned int i = 0; i < n_source_points; ++i )
+        for ( unsigned int k = 0; k < 2; ++k )
+            float_source_values_host( i, k ) = multi_source_values_host( i, k );
+    Kokkos::deep_copy( float_source_values, float_source_values_host );
+    Kokkos::View<float **, DeviceType> float_target_values(
+        "float_target_values", n_target_points, 2 );
+    mlsop.apply( float_source_values, float_target_values );
+
+    auto float_target_values_host =
+        Kokkos::create_mirror_view( float_target_values );
+    Kokkos::deep_copy( float_target_values_host, float_target_values );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+        for ( unsigned int k = 0; k < 2; ++k )
+            TEST_FLOATING_EQUALITY(
+                static_cast<double>( float_target_values_host( i, k ) ),
+                multi_target_values_host( i, k ), 1e-5 );
+
+    // Store the coefficients in single precision. The operator can still be
+    // applied to double values.
+    DataTransferKit::MovingLeastSquaresOperator<DeviceType, RadialBasisFunction,
+                                                PolynomialBasis>
+        single_mlsop( comm, source_points, target_points,
+                      PolynomialBasis::size, PointOrdering::Caller,
+                      CoefficientPrecision::Single );
+    single_mlsop.apply( float_source_values, float_target_values );
+    Kokkos::deep_copy( float_target_values_host, float_target_values );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+        for ( unsigned int k = 0; k < 2; ++k )
+            TEST_FLOATING_EQUALITY(
+                static_cast<double>( float_target_values_host( i, k ) ),
+                multi_target_values_host( i, k ), 1e-5 );
+    single_mlsop.apply( source_values, target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
+                                  1e-5 );
+    single_mlsop.apply( multi_source_values, split_target_values );
+    Kokkos::deep_copy( split_target_values_host, split_target_values );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+        for ( unsigned int k = 0; k < 2; ++k )
+            TEST_FLOATING_EQUALITY( split_target_values_host( i, k ),
+                                    multi_target_values_host( i, k ), 1e-5 );
+    auto const single_matrix = single_mlsop.getCrsMatrix();
+    TEST_EQUALITY( single_matrix.values.extent( 0 ),
+                   mlsop.getCrsMatrix().values.extent( 0 ) );
 }
 
 TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator,
@@ -420,7 +555,427 @@ TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator,
         TEST_ASSERT( std::isfinite( target_values_host[i] ) );
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator, fused_setup,
+                                   DeviceType, RadialBasisFunction,
+                                   PolynomialBasis )
+{
+    // Check that the polynomial coefficients reproduce the polynomial basis:
+    // for each target point x_i with neighbors x_j, sum_j c_j p(x_j - x_i)
+    // must be equal to p(0), i.e. one for the constant term and zero for the
+    // others.
+    using namespace DataTransferKit;
+    using Impl = Details::MovingLeastSquaresOperatorImpl<DeviceType>;
+
+    int const n_target_points = 10;
+    int const n_source_points_in_radius = 2 * PolynomialBasis::size;
+    int const n_source_points = n_target_points * n_source_points_in_radius;
+
+    std::vector<std::array<double, DIM>> source_points_arr( n_source_points );
+    std::vector<std::array<double, DIM>> target_points_arr( n_target_points );
+    Helper<DeviceType>::makeSourceTargetPoints(
+        source_points_arr, target_points_arr, n_source_points_in_radius, 1.0,
+        0 );
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+
+    Kokkos::View<int *, DeviceType> offset( "offset", n_target_points + 1 );
+    auto offset_host = Kokkos::create_mirror_view( offset );
+    for ( int i = 0; i <= n_target_points; ++i )
+        offset_host( i ) = i * n_source_points_in_radius;
+    Kokkos::deep_copy( offset, offset_host );
+
+    auto coeffs = Impl::computePolynomialCoefficientsFused(
+        offset, source_points, target_points, RadialBasisFunction(),
+        PolynomialBasis() );
+    TEST_EQUALITY( coeffs.extent_int( 0 ), n_source_points );
+
+    auto coeffs_host = Kokkos::create_mirror_view( coeffs );
+    Kokkos::deep_copy( coeffs_host, coeffs );
+    PolynomialBasis const polynomial_basis;
+    for ( int i = 0; i < n_target_points; ++i )
+    {
+        std::array<double, PolynomialBasis::size> moments;
+        moments.fill( 0. );
+        for ( int j = offset_host( i ); j < offset_host( i + 1 ); ++j )
+        {
+            std::array<double, DIM> x_j;
+            for ( int d = 0; d < DIM; ++d )
+                x_j[d] = source_points_arr[j][d] - target_points_arr[i][d];
+            auto const p_j = polynomial_basis( x_j );
+            for ( int k = 0; k < PolynomialBasis::size; ++k )
+                moments[k] += coeffs_host( j ) * p_j[k];
+        }
+        std::array<double, PolynomialBasis::size> moments_ref;
+        moments_ref.fill( 0. );
+        moments_ref[0] = 1.;
+        TEST_COMPARE_FLOATING_ARRAYS( moments, moments_ref, 1e-10 );
+    }
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator, radius,
+                                   DeviceType, RadialBasisFunction,
+                                   PolynomialBasis )
+{
+    using namespace DataTransferKit;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    std::array<int, DIM> n_source_points_grid = {40, 40, 1};
+    std::array<double, DIM> offset = {0., 0., static_cast<double>( comm_rank )};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+
+    std::array<int, DIM> n_target_points_grid = {1, 1, 1};
+    offset = {19, 19., static_cast<double>( comm_rank )};
+    auto target_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_target_points_grid, offset );
+
+    unsigned int const n_source_points = source_points_arr.size();
+    unsigned int const n_target_points = target_points_arr.size();
+    std::vector<double> source_values_arr( n_source_points );
+    std::vector<double> target_values_ref( n_target_points );
+
+    // Arbitrary function of the specified order
+    std::function<double( std::array<double, DIM> )> f;
+    switch ( PolynomialBasis::size )
+    {
+    case 1: // constant
+        f = []( std::array<double, DIM> ) -> double { return 3.0; };
+        break;
+    case 4: // linear
+        f = []( std::array<double, DIM> p ) -> double {
+            return 4 + 2 * p[0] + 3 * p[1] - 2 * p[2];
+        };
+        break;
+    case 10: // quadratic
+        f = []( std::array<double, DIM> p ) -> double {
+            return 2 + 3 * p[0] - 5 * p[1] + 2 * p[2] + 3 * p[0] * p[0] +
+                   4 * p[0] * p[1] - 2 * p[0] * p[2] + p[1] * p[1] -
+                   3 * p[1] * p[2] + 4 * p[2] * p[2];
+        };
+        break;
+    default:
+        throw;
+    };
+
+    for ( unsigned int i = 0; i < n_source_points; ++i )
+        source_values_arr[i] = f( source_points_arr[i] );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+        target_values_ref[i] = f( target_points_arr[i] );
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto source_values = Helper<DeviceType>::makeValues( source_values_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+
+    using Operator = DataTransferKit::MovingLeastSquaresOperator<
+        DeviceType, RadialBasisFunction, PolynomialBasis>;
+
+    // All the source points within the radius
+    Operator radius_mlsop( comm, source_points, target_points,
+                           DataTransferKit::SupportRadius( 3.5 ) );
+    radius_mlsop.apply( source_values, target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
+                                  1e-10 );
+
+    // Only the closest source points within the radius
+    Kokkos::View<double *, DeviceType> radius( "radius", n_target_points );
+    Kokkos::deep_copy( radius, 3.5 );
+    Operator max_mlsop( comm, source_points, target_points, radius,
+                        PolynomialBasis::size, 2 * PolynomialBasis::size );
+    max_mlsop.apply( source_values, target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
+                                  1e-10 );
+
+    // Too few source points within the radius so the operator falls back to
+    // the nearest neighbors
+    Operator knn_mlsop( comm, source_points, target_points );
+    knn_mlsop.apply( source_values, target_values );
+    std::vector<double> knn_target_values( n_target_points );
+    Kokkos::deep_copy( target_values_host, target_values );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+        knn_target_values[i] = target_values_host( i );
+    Operator min_mlsop( comm, source_points, target_points,
+                        DataTransferKit::SupportRadius( 0.5 ) );
+    min_mlsop.apply( source_values, target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, knn_target_values,
+                                  1e-11 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator, two_dim_grid,
+                                   DeviceType, RadialBasisFunction,
+                                   PolynomialBasis )
+{
+    using namespace DataTransferKit;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    int const space_dim = PolynomialBasis::dimension;
+    TEST_EQUALITY( space_dim, 2 );
+
+    // Each rank owns a 40x40 grid next to the one of the previous rank and
+    // a target point in the middle of it.
+    int const n = 40;
+    double const offset = n * comm_rank;
+    std::vector<std::array<double, 2>> source_points_arr;
+    for ( int i = 0; i < n; ++i )
+        for ( int j = 0; j < n; ++j )
+            source_points_arr.push_back( {{offset + i, 1. * j}} );
+    std::vector<std::array<double, 2>> target_points_arr = {
+        {{offset + 19.25, 19.5}}};
+
+    // Arbitrary function of the specified order
+    std::function<double( std::array<double, 2> )> f;
+    switch ( PolynomialBasis::size )
+    {
+    case 1: // constant
+        f = []( std::array<double, 2> ) -> double { return 3.0; };
+        break;
+    case 3: // linear
+        f = []( std::array<double, 2> p ) -> double {
+            return 4 + 2 * p[0] + 3 * p[1];
+        };
+        break;
+    case 6: // quadratic
+        f = []( std::array<double, 2> p ) -> double {
+            return 2 + 3 * p[0] - 5 * p[1] + 3 * p[0] * p[0] +
+                   4 * p[0] * p[1] + p[1] * p[1];
+        };
+        break;
+    default:
+        throw;
+    };
+
+    unsigned int const n_source_points = source_points_arr.size();
+    unsigned int const n_target_points = target_points_arr.size();
+    Kokkos::View<double **, DeviceType> source_points(
+        "source_points", n_source_points, space_dim );
+    Kokkos::View<double *, DeviceType> source_values( "source_values",
+                                                      n_source_points );
+    auto source_points_host = Kokkos::create_mirror_view( source_points );
+    auto source_values_host = Kokkos::create_mirror_view( source_values );
+    for ( unsigned int i = 0; i < n_source_points; ++i )
+    {
+        for ( int d = 0; d < space_dim; ++d )
+            source_points_host( i, d ) = source_points_arr[i][d];
+        source_values_host( i ) = f( source_points_arr[i] );
+    }
+    Kokkos::deep_copy( source_points, source_points_host );
+    Kokkos::deep_copy( source_values, source_values_host );
+
+    Kokkos::View<double **, DeviceType> target_points(
+        "target_points", n_target_points, space_dim );
+    auto target_points_host = Kokkos::create_mirror_view( target_points );
+    std::vector<double> target_values_ref( n_target_points );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+    {
+        for ( int d = 0; d < space_dim; ++d )
+            target_points_host( i, d ) = target_points_arr[i][d];
+        target_values_ref[i] = f( target_points_arr[i] );
+    }
+    Kokkos::deep_copy( target_points, target_points_host );
+
+    DataTransferKit::MovingLeastSquaresOperator<DeviceType, RadialBasisFunction,
+                                                PolynomialBasis>
+        mlsop( comm, source_points, target_points, 2 * PolynomialBasis::size );
+
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    mlsop.apply( source_values, target_values );
+
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
+                                  1e-10 );
+
+    // The points are not padded to three dimensions so the moment matrices
+    // are not rank-deficient.
+    auto n_ill_conditioned_host =
+        Kokkos::create_mirror_view( mlsop.getNumberOfIllConditionedTargets() );
+    Kokkos::deep_copy( n_ill_conditioned_host,
+                       mlsop.getNumberOfIllConditionedTargets() );
+    TEST_EQUALITY( n_ill_conditioned_host(), 0 );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator, morton_ordering,
+                                   DeviceType, RadialBasisFunction,
+                                   PolynomialBasis )
+{
+    using namespace DataTransferKit;
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    // Each rank owns a 12x12x12 grid on top of the one of the previous rank
+    // and target points scattered inside of it.
+    int const n = 12;
+    std::array<int, DIM> n_source_points_grid = {n, n, n};
+    std::array<double, DIM> offset = {0., 0., 1. * n * comm_rank};
+    auto source_points_arr =
+        Helper<DeviceType>::makeGridPoints( n_source_points_grid, offset );
+    unsigned int const n_target_points = 50;
+    std::vector<std::array<double, DIM>> target_points_arr( n_target_points );
+    std::default_random_engine generator( comm_rank );
+    std::uniform_real_distribution<double> distribution( 1., n - 2. );
+    for ( auto &point : target_points_arr )
+        for ( int d = 0; d < DIM; ++d )
+            point[d] = offset[d] + distribution( generator );
+
+    // Arbitrary function of the specified order
+    std::function<double( std::array<double, DIM> )> f;
+    switch ( PolynomialBasis::size )
+    {
+    case 4: // linear
+        f = []( std::array<double, DIM> p ) -> double {
+            return 4 + 2 * p[0] + 3 * p[1] - 2 * p[2];
+        };
+        break;
+    case 10: // quadratic
+        f = []( std::array<double, DIM> p ) -> double {
+            return 2 + 3 * p[0] - 5 * p[1] + 2 * p[2] + 3 * p[0] * p[0] +
+                   4 * p[0] * p[1] - 2 * p[0] * p[2] + p[1] * p[1] -
+                   3 * p[1] * p[2] + 4 * p[2] * p[2];
+        };
+        break;
+    default:
+        throw;
+    };
+
+    unsigned int const n_source_points = source_points_arr.size();
+    std::vector<double> source_values_arr( n_source_points );
+    std::vector<double> target_values_ref( n_target_points );
+    for ( unsigned int i = 0; i < n_source_points; ++i )
+        source_values_arr[i] = f( source_points_arr[i] );
+    for ( unsigned int i = 0; i < n_target_points; ++i )
+        target_values_ref[i] = f( target_points_arr[i] );
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto source_values = Helper<DeviceType>::makeValues( source_values_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::View<double *, DeviceType> morton_target_values( "target_values",
+                                                             n_target_points );
+    auto morton_target_values_host =
+        Kokkos::create_mirror_view( morton_target_values );
+
+    using Operator = DataTransferKit::MovingLeastSquaresOperator<
+        DeviceType, RadialBasisFunction, PolynomialBasis>;
+
+    // Searching for the neighbors along the Morton curve does not change the
+    // results, nor their order.
+    Operator knn_mlsop( comm, source_points, target_points,
+                        2 * PolynomialBasis::size, PointOrdering::Caller );
+    knn_mlsop.apply( source_values, target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
+                                  1e-10 );
+    Operator morton_knn_mlsop( comm, source_points, target_points,
+                               2 * PolynomialBasis::size,
+                               PointOrdering::Morton );
+    morton_knn_mlsop.apply( source_values, morton_target_values );
+    Kokkos::deep_copy( morton_target_values_host, morton_target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( morton_target_values_host,
+                                  target_values_host, 1e-14 );
+
+    double const radius = 2.5;
+    Operator radius_mlsop( comm, source_points, target_points,
+                           DataTransferKit::SupportRadius( radius ),
+                           PolynomialBasis::size,
+                           std::numeric_limits<int>::max(),
+                           PointOrdering::Caller );
+    radius_mlsop.apply( source_values, target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( target_values_host, target_values_ref,
+                                  1e-10 );
+    Operator morton_radius_mlsop( comm, source_points, target_points,
+                                  DataTransferKit::SupportRadius( radius ),
+                                  PolynomialBasis::size,
+                                  std::numeric_limits<int>::max(),
+                                  PointOrdering::Morton );
+    morton_radius_mlsop.apply( source_values, morton_target_values );
+    Kokkos::deep_copy( morton_target_values_host, morton_target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( morton_target_values_host,
+                                  target_values_host, 1e-14 );
+}
+
 // Include the test macros.
+TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MovingLeastSquaresOperator,
+                                   shared_source_points, DeviceType,
+                                   RadialBasisFunction, PolynomialBasis )
+{
+    // Two target points close to each other have the same neighbors, which
+    // are all the source points of this rank. Each of these source points
+    // must be a single column of the matrix.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    int const n_source_points = 2 * PolynomialBasis::size;
+    std::vector<std::array<double, DIM>> source_points_arr( n_source_points );
+    std::vector<std::array<double, DIM>> target_points_arr( 1 );
+    Helper<DeviceType>::makeSourceTargetPoints(
+        source_points_arr, target_points_arr, n_source_points, 1.0, comm_rank );
+    auto shifted_target_point = target_points_arr[0];
+    shifted_target_point[0] += 0.01;
+    target_points_arr.push_back( shifted_target_point );
+    int const n_target_points = target_points_arr.size();
+
+    std::vector<double> source_values_arr( n_source_points );
+    std::iota( source_values_arr.begin(), source_values_arr.end(), 1. );
+
+    auto source_points = Helper<DeviceType>::makePoints( source_points_arr );
+    auto target_points = Helper<DeviceType>::makePoints( target_points_arr );
+    auto source_values = Helper<DeviceType>::makeValues( source_values_arr );
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+
+    DataTransferKit::MovingLeastSquaresOperator<DeviceType, RadialBasisFunction,
+                                                PolynomialBasis>
+        mlsop( comm, source_points, target_points, n_source_points );
+    mlsop.apply( source_values, target_values );
+
+    auto const matrix = mlsop.getCrsMatrix();
+    TEST_EQUALITY( matrix.entries.extent_int( 0 ),
+                   n_target_points * n_source_points );
+    TEST_EQUALITY( matrix.column_ranks.extent_int( 0 ), n_source_points );
+    auto column_ranks_host = Kokkos::create_mirror_view( matrix.column_ranks );
+    Kokkos::deep_copy( column_ranks_host, matrix.column_ranks );
+    auto column_indices_host =
+        Kokkos::create_mirror_view( matrix.column_indices );
+    Kokkos::deep_copy( column_indices_host, matrix.column_indices );
+    std::vector<int> column_ranks_ref( n_source_points, comm_rank );
+    std::vector<int> column_indices_ref( n_source_points );
+    std::iota( column_indices_ref.begin(), column_indices_ref.end(), 0 );
+    TEST_COMPARE_ARRAYS( column_ranks_host, column_ranks_ref );
+    TEST_COMPARE_ARRAYS( column_indices_host, column_indices_ref );
+
+    // The halo exchange imports each source value once and the product
+    // gives the same result as apply().
+    Kokkos::View<double *, DeviceType> crs_target_values( "target_values",
+                                                          n_target_points );
+    mlsop.applyCrsMatrix( matrix, source_values, crs_target_values );
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    auto crs_target_values_host =
+        Kokkos::create_mirror_view( crs_target_values );
+    Kokkos::deep_copy( crs_target_values_host, crs_target_values );
+    TEST_COMPARE_FLOATING_ARRAYS( crs_target_values_host, target_values_host,
+                                  1e-14 );
+}
+
 #include "DataTransferKit_ETIHelperMacros.h"
 
 using Wendland0 = DataTransferKit::Wendland<0>;
@@ -432,6 +987,10 @@ using Linear3 =
     DataTransferKit::MultivariatePolynomialBasis<DataTransferKit::Linear, 3>;
 using Quadratic3 =
     DataTransferKit::MultivariatePolynomialBasis<DataTransferKit::Quadratic, 3>;
+using Linear2 =
+    DataTransferKit::MultivariatePolynomialBasis<DataTransferKit::Linear, 2>;
+using Quadratic2 =
+    DataTransferKit::MultivariatePolynomialBasis<DataTransferKit::Quadratic, 2>;
 
 // Create the test group
 #define UNIT_TEST_GROUP( NODE )                                                \
@@ -471,7 +1030,38 @@ using Quadratic3 =
         Wendland0, Linear3 )                                                   \
     TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT(                                      \
         MovingLeastSquaresOperator, single_point_in_radius, DeviceType##NODE,  \
-        Wendland0, Quadratic3 )
+        Wendland0, Quadratic3 )                                                \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator,          \
+                                          fused_setup, DeviceType##NODE,       \
+                                          Wendland0, Linear3 )                 \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator,          \
+                                          fused_setup, DeviceType##NODE,       \
+                                          Wendland2, Quadratic3 )              \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator, radius,  \
+                                          DeviceType##NODE, Wendland0,         \
+                                          Constant3 )                          \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator, radius,  \
+                                          DeviceType##NODE, Wendland0,         \
+                                          Linear3 )                            \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator, radius,  \
+                                          DeviceType##NODE, Wendland0,         \
+                                          Quadratic3 )                         \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator,          \
+                                          two_dim_grid, DeviceType##NODE,      \
+                                          Wendland0, Linear2 )                 \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator,          \
+                                          two_dim_grid, DeviceType##NODE,      \
+                                          Wendland0, Quadratic2 )              \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator,          \
+                                          morton_ordering, DeviceType##NODE,   \
+                                          Wendland0, Linear3 )                 \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator,          \
+                                          morton_ordering, DeviceType##NODE,   \
+                                          Wendland2, Quadratic3 )              \
+    TEUCHOS_UNIT_TEST_TEMPLATE_3_INSTANT( MovingLeastSquaresOperator,          \
+                                          shared_source_points,                \
+                                          DeviceType##NODE, Wendland0,         \
+                                          Linear3 )
 
 // Demangle the types
 DTK_ETI_MANGLING_TYPEDEFS()
@@ -204,6 +204,122 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, structured_clouds,
     for ( unsigned int i = 0; i < n_points; ++i )
         TEST_FLOATING_EQUALITY( target_values_host( i ),
                                 target_points_host( i, 0 ), 1e-14 );
+
+    // Apply the operator a second time to check that the communication plan
+    // can be reused with different values.
+    Kokkos::deep_copy( source_values,
+                       Kokkos::subview( source_points, Kokkos::ALL, 1 ) );
+
+    nnop.apply( source_values, target_values );
+
+    Kokkos::deep_copy( target_values_host, target_values );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        TEST_FLOATING_EQUALITY( target_values_host( i ),
+                                target_points_host( i, 1 ), 1e-14 );
+    // Transfer all the coordinates at once as a multi-field.
+    Kokkos::View<double **, DeviceType> multi_target_values(
+        "multi_target_values", n_points, 3 );
+    nnop.apply( source_points, multi_target_values );
+
+    auto multi_target_values_host =
+        Kokkos::create_mirror_view( multi_target_values );
+    Kokkos::deep_copy( multi_target_values_host, multi_target_values );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        for ( unsigned int d = 0; d < 3; ++d )
+            TEST_FLOATING_EQUALITY( multi_target_values_host( i, d ),
+                                    target_points_host( i, d ), 1e-14 );
+
+    // Split the application to overlap the communication with other work.
+    Kokkos::deep_copy( multi_target_values, 0. );
+    nnop.applyBegin( source_points, multi_target_values );
+    nnop.applyEnd( multi_target_values );
+
+    Kokkos::deep_copy( multi_target_values_host, multi_target_values );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        for ( unsigned int d = 0; d < 3; ++d )
+            TEST_FLOATING_EQUALITY( multi_target_values_host( i, d ),
+                                    target_points_host( i, d ), 1e-14 );
+
+    // Transfer the coordinates in single precision.
+    Kokkos::View<float **, DeviceType> float_source_values(
+        "float_source_values", n_points, 3 );
+    auto float_source_values_host =
+        Kokkos::create_mirror_view( float_source_values );
+    auto source_points_host = Kokkos::create_mirror_view( source_points );
+    Kokkos::deep_copy( source_points_host, source_points );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        for ( unsigned int d = 0; d < 3; ++d )
+            float_source_values_host( i, d ) = source_points_host( i, d );
+    Kokkos::deep_copy( float_source_values, float_source_values_host );
+    Kokkos::View<float **, DeviceType> float_target_values(
+        "float_target_values", n_points, 3 );
+    nnop.apply( float_source_values, float_target_values );
+
+    auto float_target_values_host =
+        Kokkos::create_mirror_view( float_target_values );
+    Kokkos::deep_copy( float_target_values_host, float_target_values );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        for ( unsigned int d = 0; d < 3; ++d )
+            TEST_EQUALITY( float_target_values_host( i, d ),
+                           static_cast<float>( target_points_host( i, d ) ) );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, two_dim_clouds,
+                                   DeviceType )
+{
+    // Same as structured_clouds with two-dimensional points.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    double const Lx = 2.;
+    double const Ly = 3.;
+    unsigned int const nx = 7;
+    unsigned int const ny = 11;
+    int const space_dim = 2;
+
+    auto const source_cloud = makeStructuredCloud(
+        Lx, Ly, 0., nx, ny, 1, comm_rank * Lx, comm_rank * Ly );
+    auto const target_cloud = makeStructuredCloud(
+        Lx, Ly, 0., nx, ny, 1, ( ( comm_rank + 1 ) % comm_size ) * Lx,
+        ( ( comm_rank + 1 ) % comm_size ) * Ly );
+    unsigned int const n_points = source_cloud.size();
+
+    Kokkos::View<double **, DeviceType> source_points( "source_points",
+                                                       n_points, space_dim );
+    Kokkos::View<double **, DeviceType> target_points( "target_points",
+                                                       n_points, space_dim );
+    auto source_points_host = Kokkos::create_mirror_view( source_points );
+    auto target_points_host = Kokkos::create_mirror_view( target_points );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        for ( int d = 0; d < space_dim; ++d )
+        {
+            source_points_host( i, d ) = source_cloud[i][d];
+            target_points_host( i, d ) = target_cloud[i][d];
+        }
+    Kokkos::deep_copy( source_points, source_points_host );
+    Kokkos::deep_copy( target_points, target_points_host );
+
+    // The points must have the dimension of the operator
+    TEST_THROW( DataTransferKit::NearestNeighborOperator<DeviceType>(
+                    comm, source_points, target_points ),
+                DataTransferKit::DataTransferKitException );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType, space_dim> nnop(
+        comm, source_points, target_points );
+
+    Kokkos::View<double **, DeviceType> target_values( "target_values",
+                                                       n_points, space_dim );
+    nnop.apply( source_points, target_values );
+
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    for ( unsigned int i = 0; i < n_points; ++i )
+        for ( int d = 0; d < space_dim; ++d )
+            TEST_FLOATING_EQUALITY( target_values_host( i, d ),
+                                    target_points_host( i, d ), 1e-14 );
 }
 
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, mixed_clouds,
@@ -266,6 +382,84 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, mixed_clouds,
             ref_value -= Lx / nx;
         TEST_FLOATING_EQUALITY( target_values_host( i ), ref_value, 1e-14 );
     }
+    // Apply the operator as a halo exchange followed by a sparse
+    // matrix-vector product and check that it gives the same result.
+    auto const matrix = nnop.getCrsMatrix();
+    TEST_EQUALITY( matrix.row_map.extent( 0 ), n_target_points + 1 );
+    TEST_EQUALITY( matrix.entries.extent( 0 ), n_target_points );
+    Kokkos::View<double *, DeviceType> crs_target_values( "target_values",
+                                                          n_target_points );
+    nnop.applyCrsMatrix( matrix, source_values, crs_target_values );
+    auto crs_target_values_host =
+        Kokkos::create_mirror_view( crs_target_values );
+    Kokkos::deep_copy( crs_target_values_host, crs_target_values );
+    TEST_COMPARE_ARRAYS( crs_target_values_host, target_values_host );
+
+    // Searching for the nearest neighbors along the Morton curve does not
+    // change the results, nor their order.
+    DataTransferKit::NearestNeighborOperator<DeviceType> morton_nnop(
+        comm, source_points, target_points,
+        DataTransferKit::PointOrdering::Morton );
+    Kokkos::View<double *, DeviceType> morton_target_values( "target_values",
+                                                             n_target_points );
+    morton_nnop.apply( source_values, morton_target_values );
+    auto morton_target_values_host =
+        Kokkos::create_mirror_view( morton_target_values );
+    Kokkos::deep_copy( morton_target_values_host, morton_target_values );
+    TEST_COMPARE_ARRAYS( morton_target_values_host, target_values_host );
+}
+
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator,
+                                   shared_source_point, DeviceType )
+{
+    MPI_Comm comm = MPI_COMM_WORLD;
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    // Each rank owns the source points (r, 0, 0) and (r, 1, 0). The first
+    // three target points of every rank are closest to the source point 0 of
+    // rank 0 and the last one to the source point 1 of this rank.
+    double const r = comm_rank;
+    Kokkos::View<double **, DeviceType> source_points( "source_points" );
+    copyPointsFromCloud<DeviceType>( {{{r, 0., 0.}}, {{r, 1., 0.}}},
+                                     source_points );
+    Kokkos::View<double **, DeviceType> target_points( "target_points" );
+    copyPointsFromCloud<DeviceType>( {{{.1, 0., 0.}},
+                                      {{0., .1, 0.}},
+                                      {{0., 0., .1}},
+                                      {{r, .9, 0.}}},
+                                     target_points );
+    unsigned int const n_target_points = target_points.extent( 0 );
+
+    DataTransferKit::NearestNeighborOperator<DeviceType> nnop(
+        comm, source_points, target_points );
+
+    // The source point shared by the first three rows is a single column.
+    auto const matrix = nnop.getCrsMatrix();
+    auto entries_host = Kokkos::create_mirror_view( matrix.entries );
+    Kokkos::deep_copy( entries_host, matrix.entries );
+    auto column_ranks_host = Kokkos::create_mirror_view( matrix.column_ranks );
+    Kokkos::deep_copy( column_ranks_host, matrix.column_ranks );
+    auto column_indices_host =
+        Kokkos::create_mirror_view( matrix.column_indices );
+    Kokkos::deep_copy( column_indices_host, matrix.column_indices );
+    TEST_COMPARE_ARRAYS( entries_host, std::vector<int>( {0, 0, 0, 1} ) );
+    TEST_COMPARE_ARRAYS( column_ranks_host,
+                         std::vector<int>( {0, comm_rank} ) );
+    TEST_COMPARE_ARRAYS( column_indices_host, std::vector<int>( {0, 1} ) );
+
+    Kokkos::View<double *, DeviceType> source_values( "source_values", 2 );
+    auto source_values_host = Kokkos::create_mirror_view( source_values );
+    source_values_host( 0 ) = 10. * r;
+    source_values_host( 1 ) = 10. * r + 1.;
+    Kokkos::deep_copy( source_values, source_values_host );
+    Kokkos::View<double *, DeviceType> target_values( "target_values",
+                                                      n_target_points );
+    nnop.applyCrsMatrix( matrix, source_values, target_values );
+    auto target_values_host = Kokkos::create_mirror_view( target_values );
+    Kokkos::deep_copy( target_values_host, target_values );
+    TEST_COMPARE_ARRAYS( target_values_host,
+                         std::vector<double>( {0., 0., 0., 10. * r + 1.} ) );
 }
 
 // Include the test macros.
@@ -279,7 +473,11 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( NearestNeighborOperator, mixed_clouds,
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
         NearestNeighborOperator, structured_clouds, DeviceType##NODE )         \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator,             \
-                                          mixed_clouds, DeviceType##NODE )
+                                          mixed_clouds, DeviceType##NODE )     \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( NearestNeighborOperator,             \
+                                          two_dim_clouds, DeviceType##NODE )   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT(                                      \
+        NearestNeighborOperator, shared_source_point, DeviceType##NODE )
 
 // Demangle the types
 DTK_ETI_MANGLING_TYPEDEFS()
@@ -13,6 +13,7 @@
 
 #include <DTK_DBC.hpp>
 #include <DTK_DetailsSVDImpl.hpp>
+#include <DTK_DetailsSymmetricSolverImpl.hpp>
 
 #include <Kokkos_View.hpp>
 
@@ -149,6 +150,92 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, rank_deficient, DeviceType )
                   rank_deficiency, out, success );
 }
 
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, symmetric_solver, DeviceType )
+{
+    // Compute the first row of the inverse of symmetric positive semi-definite
+    // matrices M^T M. Half of the matrices have a zero row and column, in which
+    // case the solver must fall back to the pseudo-inverse.
+    int constexpr matrix_size = 4;
+    int const n_matrices = 10;
+    int const rank_deficiency = 2;
+    Kokkos::View<double *, DeviceType> matrices(
+        "matrices", n_matrices * matrix_size * matrix_size );
+    Kokkos::View<double *, DeviceType> rows( "rows",
+                                             n_matrices * matrix_size );
+    Kokkos::View<int *, DeviceType> used_svd( "used_svd", n_matrices );
+
+    // Fill the matrices
+    auto matrices_host = Kokkos::create_mirror_view( matrices );
+    std::default_random_engine random_engine;
+    std::uniform_real_distribution<double> distribution( -10, 10 );
+    for ( int m = 0; m < n_matrices; ++m )
+    {
+        double tmp[matrix_size][matrix_size];
+        for ( int i = 0; i < matrix_size; ++i )
+            for ( int j = 0; j < matrix_size; ++j )
+                tmp[i][j] = ( m % 2 == 1 && j == rank_deficiency )
+                                ? 0.
+                                : distribution( random_engine );
+        for ( int i = 0; i < matrix_size; ++i )
+            for ( int j = 0; j < matrix_size; ++j )
+            {
+                double value = 0.;
+                for ( int k = 0; k < matrix_size; ++k )
+                    value += tmp[k][i] * tmp[k][j];
+                matrices_host( ( m * matrix_size + i ) * matrix_size + j ) =
+                    value;
+            }
+    }
+    Kokkos::deep_copy( matrices, matrices_host );
+
+    using ExecutionSpace = typename DeviceType::execution_space;
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "compute_first_row" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_matrices ),
+        KOKKOS_LAMBDA( int const m ) {
+            DataTransferKit::Details::SquareMatrix<matrix_size> a;
+            for ( int i = 0; i < matrix_size; ++i )
+                for ( int j = 0; j < matrix_size; ++j )
+                    a( i, j ) =
+                        matrices( ( m * matrix_size + i ) * matrix_size + j );
+            Kokkos::Array<double, matrix_size> x;
+            used_svd( m ) = DataTransferKit::Details::SymmetricSolver<
+                DeviceType, matrix_size>::firstRowOfInverse( a, x );
+            for ( int j = 0; j < matrix_size; ++j )
+                rows( m * matrix_size + j ) = x[j];
+        } );
+
+    auto rows_host = Kokkos::create_mirror_view( rows );
+    Kokkos::deep_copy( rows_host, rows );
+    auto used_svd_host = Kokkos::create_mirror_view( used_svd );
+    Kokkos::deep_copy( used_svd_host, used_svd );
+
+    // Multiply the row with the matrix and check that the result is the first
+    // row of the identity (restricted to the range of the matrix).
+    double const relative_tolerance = 1e-10;
+    for ( int m = 0; m < n_matrices; ++m )
+    {
+        bool const is_rank_deficient = ( m % 2 == 1 );
+        TEST_EQUALITY( used_svd_host( m ) != 0, is_rank_deficient );
+        for ( int j = 0; j < matrix_size; ++j )
+        {
+            double result = 0.;
+            for ( int k = 0; k < matrix_size; ++k )
+                result +=
+                    rows_host( m * matrix_size + k ) *
+                    matrices_host( ( m * matrix_size + k ) * matrix_size + j );
+            if ( j == 0 )
+                TEST_FLOATING_EQUALITY( result, 1., relative_tolerance );
+            else
+                TEST_FLOATING_EQUALITY( result + 1, 1., relative_tolerance );
+        }
+        if ( is_rank_deficient )
+            TEST_FLOATING_EQUALITY(
+                rows_host( m * matrix_size + rank_deficiency ) + 1, 1.,
+                relative_tolerance );
+    }
+}
+
 // Include the test macros.
 #include "DataTransferKit_ETIHelperMacros.h"
 
@@ -157,6 +244,8 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( SVD, rank_deficient, DeviceType )
     using DeviceType##NODE = typename NODE::device_type;                       \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( SVD, full_rank, DeviceType##NODE )   \
     TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( SVD, rank_deficient,                 \
+                                          DeviceType##NODE )                   \
+    TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( SVD, symmetric_solver,               \
                                           DeviceType##NODE )
 // Demangle the types
 DTK_ETI_MANGLING_TYPEDEFS()
@@ -0,0 +1,357 @@
+/****************************************************************************
+ * Copyright (c) 2012-2019 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_DETAILS_DISTRIBUTOR_HPP
+#define DTK_DETAILS_DISTRIBUTOR_HPP
+
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <mpi.h>
+
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DataTransferKit
+{
+namespace Details
+{
+/**
+ * Communication plan that sends the rows of a View to other processors.
+ *
+ * Contrary to the distributor used by the search, the exchange is split in
+ * two: doPosts() packs the values and posts non-blocking sends and receives,
+ * and doWaits() completes the communication and unpacks the values. Work that
+ * does not depend on the values received can be done in between. The rows
+ * that a processor sends to itself do not go through MPI and are available as
+ * soon as doPosts() returns.
+ *
+ * The rows received are sorted by rank of the sending processor and, for a
+ * given processor, they are in the order in which they were exported.
+ */
+/**
+ * Whether a distributor communicates through a duplicate of the communicator
+ * it is given or through the communicator itself.
+ */
+enum class CommunicatorUse
+{
+    Duplicate,
+    Borrow
+};
+
+template <typename DeviceType>
+class Distributor
+{
+  public:
+    using ExecutionSpace = typename DeviceType::execution_space;
+
+    // By default, the communication goes through a duplicate of the
+    // communicator so that the messages of several distributors with posted
+    // sends and receives cannot be mixed up. Duplicating a communicator is a
+    // collective operation, which is a waste for a plan used for a single
+    // blocking exchange: such a distributor can borrow the communicator
+    // instead, as long as no other exchange is pending on it in between.
+    Distributor( MPI_Comm comm,
+                 CommunicatorUse use = CommunicatorUse::Duplicate )
+        : _comm_ptr( use == CommunicatorUse::Duplicate
+                         ? duplicate( comm )
+                         : std::make_shared<MPI_Comm>( comm ) )
+        , _comm( *_comm_ptr )
+        , _permute( "permute", 0 )
+        , _send_buffer( "send_buffer", 0 )
+        , _receive_buffer( "receive_buffer", 0 )
+        , _host_send_buffer( Kokkos::create_mirror_view( _send_buffer ) )
+        , _host_receive_buffer( Kokkos::create_mirror_view( _receive_buffer ) )
+    {
+        MPI_Comm_rank( _comm, &_comm_rank );
+        int comm_size;
+        MPI_Comm_size( _comm, &comm_size );
+        _send_offsets.assign( comm_size + 1, 0 );
+        _receive_offsets.assign( comm_size + 1, 0 );
+    }
+
+    // A distributor owns its communicator, its buffers and its pending
+    // requests. It is not copied: two copies would post their exchanges on
+    // the same communicator and in the same buffers.
+    Distributor( Distributor const & ) = delete;
+    Distributor &operator=( Distributor const & ) = delete;
+    Distributor( Distributor && ) = default;
+    Distributor &operator=( Distributor && ) = default;
+
+    /**
+     * Build the plan. This is a collective operation.
+     * @param destination_ranks rank of the processor each row is sent to
+     * @return number of rows received
+     */
+    size_t
+    createFromSends( Kokkos::View<int const *, DeviceType> destination_ranks )
+    {
+        DTK_REQUIRE( !_posted );
+        int const comm_size = _send_offsets.size() - 1;
+        int const n_exports = destination_ranks.extent( 0 );
+        Kokkos::View<int *, Kokkos::HostSpace> ranks_host( "destination_ranks",
+                                                           n_exports );
+        Kokkos::deep_copy( ranks_host, destination_ranks );
+
+        // Sort the rows by destination with a stable counting sort
+        std::vector<int> send_counts( comm_size, 0 );
+        for ( int i = 0; i < n_exports; ++i )
+            ++send_counts[ranks_host( i )];
+        for ( int r = 0; r < comm_size; ++r )
+            _send_offsets[r + 1] = _send_offsets[r] + send_counts[r];
+        _permute = Kokkos::View<int *, DeviceType>( "permute", n_exports );
+        auto permute_host = Kokkos::create_mirror_view( _permute );
+        std::vector<int> position( _send_offsets.begin(),
+                                   _send_offsets.end() - 1 );
+        for ( int i = 0; i < n_exports; ++i )
+            permute_host( i ) = position[ranks_host( i )]++;
+        Kokkos::deep_copy( _permute, permute_host );
+
+        std::vector<int> receive_counts( comm_size );
+        MPI_Alltoall( send_counts.data(), 1, MPI_INT, receive_counts.data(), 1,
+                      MPI_INT, _comm );
+        for ( int r = 0; r < comm_size; ++r )
+            _receive_offsets[r + 1] = _receive_offsets[r] + receive_counts[r];
+
+        return getTotalReceiveLength();
+    }
+
+    size_t getTotalReceiveLength() const { return _receive_offsets.back(); }
+
+    size_t getTotalSendLength() const { return _send_offsets.back(); }
+
+    /**
+     * Range of the rows received that were sent by this processor.
+     */
+    std::pair<size_t, size_t> getSelfReceiveRange() const
+    {
+        return std::make_pair( _receive_offsets[_comm_rank],
+                               _receive_offsets[_comm_rank + 1] );
+    }
+
+    /**
+     * Pack \p exports and post the communication. \p exports can be modified
+     * as soon as this function returns but \p imports is only complete after
+     * doWaits(), except for the rows in getSelfReceiveRange().
+     */
+    template <typename ExportView, typename ImportView>
+    void doPosts( ExportView const &exports, ImportView const &imports )
+    {
+        using ValueType = typename ImportView::non_const_value_type;
+        static_assert( ImportView::rank <= 2 &&
+                           ExportView::rank == ImportView::rank,
+                       "doPosts() requires rank-1 or rank-2 View arguments" );
+        static_assert( std::is_same<typename ExportView::non_const_value_type,
+                                    ValueType>::value,
+                       "doPosts() requires Views of the same value type" );
+        DTK_REQUIRE( !_posted );
+        DTK_REQUIRE( exports.extent( 0 ) == getTotalSendLength() );
+        DTK_REQUIRE( imports.extent( 0 ) == getTotalReceiveLength() );
+        DTK_REQUIRE( exports.extent( 1 ) == imports.extent( 1 ) );
+
+        int const n_exports = getTotalSendLength();
+        int const n_imports = getTotalReceiveLength();
+        int const n_components = exports.extent( 1 );
+        size_t const row_size = n_components * sizeof( ValueType );
+        // The messages are counted in bytes by MPI, with an int.
+        size_t const max_message_size = std::numeric_limits<int>::max();
+        int const comm_size = _send_offsets.size() - 1;
+        for ( int r = 0; r < comm_size; ++r )
+        {
+            DTK_INSIST( ( _send_offsets[r + 1] - _send_offsets[r] ) *
+                            row_size <=
+                        max_message_size );
+            DTK_INSIST( ( _receive_offsets[r + 1] - _receive_offsets[r] ) *
+                            row_size <=
+                        max_message_size );
+        }
+        reserve( _send_buffer, _host_send_buffer, n_exports * row_size );
+        reserve( _receive_buffer, _host_receive_buffer, n_imports * row_size );
+
+        // Pack the rows sorted by destination
+        auto send_buffer = getBuffer<ValueType>( _send_buffer, n_exports,
+                                                 n_components );
+        Kokkos::View<int *, DeviceType> permute = _permute;
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "pack_exports" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_exports ),
+            KOKKOS_LAMBDA( int const i ) {
+                for ( int j = 0; j < n_components; ++j )
+                    send_buffer( permute( i ), j ) = exports.access( i, j );
+            } );
+        Kokkos::fence();
+
+        // The rows sent to this processor are copied directly
+        int const self_send_offset = _send_offsets[_comm_rank];
+        int const self_receive_offset = _receive_offsets[_comm_rank];
+        int const n_self = _receive_offsets[_comm_rank + 1] -
+                           _receive_offsets[_comm_rank];
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "copy_self_exports" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_self ),
+            KOKKOS_LAMBDA( int const i ) {
+                for ( int j = 0; j < n_components; ++j )
+                    imports.access( self_receive_offset + i, j ) =
+                        send_buffer( self_send_offset + i, j );
+            } );
+        Kokkos::fence();
+
+        // MPI only sees host memory. When the device memory is accessible
+        // from the host, the mirrors alias the buffers and nothing is copied.
+        Kokkos::deep_copy(
+            Kokkos::subview( _host_send_buffer,
+                             std::make_pair( size_t( 0 ),
+                                             n_exports * row_size ) ),
+            Kokkos::subview( _send_buffer,
+                             std::make_pair( size_t( 0 ),
+                                             n_exports * row_size ) ) );
+
+        int const tag = 123;
+        for ( int r = 0; r < comm_size; ++r )
+        {
+            int const n_rows = _receive_offsets[r + 1] - _receive_offsets[r];
+            if ( r != _comm_rank && n_rows > 0 )
+            {
+                _requests.emplace_back();
+                MPI_Irecv( _host_receive_buffer.data() +
+                               _receive_offsets[r] * row_size,
+                           n_rows * row_size, MPI_BYTE, r, tag, _comm,
+                           &_requests.back() );
+            }
+        }
+        for ( int r = 0; r < comm_size; ++r )
+        {
+            int const n_rows = _send_offsets[r + 1] - _send_offsets[r];
+            if ( r != _comm_rank && n_rows > 0 )
+            {
+                _requests.emplace_back();
+                MPI_Isend( _host_send_buffer.data() +
+                               _send_offsets[r] * row_size,
+                           n_rows * row_size, MPI_BYTE, r, tag, _comm,
+                           &_requests.back() );
+            }
+        }
+        _row_size = row_size;
+        _posted = true;
+    }
+
+    /**
+     * Complete the communication posted by doPosts() and unpack the rows
+     * received from the other processors in \p imports.
+     */
+    template <typename ImportView>
+    void doWaits( ImportView const &imports )
+    {
+        using ValueType = typename ImportView::non_const_value_type;
+        DTK_REQUIRE( _posted );
+        DTK_REQUIRE( imports.extent( 0 ) == getTotalReceiveLength() );
+        DTK_REQUIRE( imports.extent( 1 ) * sizeof( ValueType ) == _row_size );
+
+        MPI_Waitall( _requests.size(), _requests.data(), MPI_STATUSES_IGNORE );
+        _requests.clear();
+        _posted = false;
+
+        int const n_imports = getTotalReceiveLength();
+        int const n_components = imports.extent( 1 );
+        Kokkos::deep_copy(
+            Kokkos::subview( _receive_buffer,
+                             std::make_pair( size_t( 0 ),
+                                             n_imports * _row_size ) ),
+            Kokkos::subview( _host_receive_buffer,
+                             std::make_pair( size_t( 0 ),
+                                             n_imports * _row_size ) ) );
+
+        auto receive_buffer = getBuffer<ValueType>( _receive_buffer, n_imports,
+                                                    n_components );
+        int const self_first = _receive_offsets[_comm_rank];
+        int const self_last = _receive_offsets[_comm_rank + 1];
+        Kokkos::parallel_for(
+            DTK_MARK_REGION( "unpack_imports" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_imports ),
+            KOKKOS_LAMBDA( int const i ) {
+                if ( i < self_first || i >= self_last )
+                    for ( int j = 0; j < n_components; ++j )
+                        imports.access( i, j ) = receive_buffer( i, j );
+            } );
+        Kokkos::fence();
+    }
+
+    template <typename ExportView, typename ImportView>
+    void doPostsAndWaits( ExportView const &exports, ImportView const &imports )
+    {
+        doPosts( exports, imports );
+        doWaits( imports );
+    }
+
+  private:
+    using HostBuffer = typename Kokkos::View<char *, DeviceType>::HostMirror;
+
+    static std::shared_ptr<MPI_Comm> duplicate( MPI_Comm comm )
+    {
+        std::shared_ptr<MPI_Comm> comm_ptr( new MPI_Comm, []( MPI_Comm *p ) {
+            // The communicator cannot be freed after MPI_Finalize()
+            int finalized;
+            MPI_Finalized( &finalized );
+            if ( !finalized )
+                MPI_Comm_free( p );
+            delete p;
+        } );
+        MPI_Comm_dup( comm, comm_ptr.get() );
+        return comm_ptr;
+    }
+
+    static void reserve( Kokkos::View<char *, DeviceType> &buffer,
+                         HostBuffer &host_buffer, size_t size )
+    {
+        if ( buffer.extent( 0 ) < size )
+        {
+            buffer = Kokkos::View<char *, DeviceType>( buffer.label(), size );
+            host_buffer = Kokkos::create_mirror_view( buffer );
+        }
+    }
+
+    template <typename ValueType>
+    static Kokkos::View<ValueType **, Kokkos::LayoutRight, DeviceType,
+                        Kokkos::MemoryUnmanaged>
+    getBuffer( Kokkos::View<char *, DeviceType> const &buffer, int n_rows,
+               int n_components )
+    {
+        return Kokkos::View<ValueType **, Kokkos::LayoutRight, DeviceType,
+                            Kokkos::MemoryUnmanaged>(
+            reinterpret_cast<ValueType *>( buffer.data() ), n_rows,
+            n_components );
+    }
+
+    std::shared_ptr<MPI_Comm> _comm_ptr;
+    MPI_Comm _comm;
+    int _comm_rank;
+    std::vector<int> _send_offsets;
+    std::vector<int> _receive_offsets;
+    // Position of each exported row in the send buffer
+    Kokkos::View<int *, DeviceType> _permute;
+    Kokkos::View<char *, DeviceType> _send_buffer;
+    Kokkos::View<char *, DeviceType> _receive_buffer;
+    HostBuffer _host_send_buffer;
+    HostBuffer _host_receive_buffer;
+    std::vector<MPI_Request> _requests;
+    size_t _row_size = 0;
+    bool _posted = false;
+};
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif
@@ -0,0 +1,221 @@
+/****************************************************************************
+ * Copyright (c) 2012-2019 by the DataTransferKit authors                   *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the DataTransferKit library. DataTransferKit is     *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef DTK_POINT_ORDERING_HPP
+#define DTK_POINT_ORDERING_HPP
+
+#include <DTK_ConfigDefs.hpp>
+#include <DTK_DBC.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_Sort.hpp>
+
+namespace DataTransferKit
+{
+/**
+ * Order in which the points are processed internally. With Morton, the points
+ * are sorted along a Z-order curve before the search so that consecutive
+ * queries traverse the same parts of the search tree. The results are always
+ * returned in the order of the points given by the caller.
+ */
+enum class PointOrdering
+{
+    Caller,
+    Morton
+};
+
+namespace Details
+{
+// Insert two zeros after each of the 10 lowest bits of v.
+KOKKOS_INLINE_FUNCTION unsigned int expandBits( unsigned int v )
+{
+    v = ( v * 0x00010001u ) & 0xFF0000FFu;
+    v = ( v * 0x00000101u ) & 0x0F00F00Fu;
+    v = ( v * 0x00000011u ) & 0xC30C30C3u;
+    v = ( v * 0x00000005u ) & 0x49249249u;
+    return v;
+}
+
+// Map a coordinate of the unit interval to one of 1024 cells.
+KOKKOS_INLINE_FUNCTION unsigned int quantize( double t )
+{
+    double const cell = t * 1024.;
+    return cell < 0. ? 0u : cell >= 1023. ? 1023u : (unsigned int)cell;
+}
+
+// 30-bit Morton code of a point of the unit cube.
+KOKKOS_INLINE_FUNCTION unsigned int morton3D( double x, double y, double z )
+{
+    return ( expandBits( quantize( x ) ) << 2 ) +
+           ( expandBits( quantize( y ) ) << 1 ) + expandBits( quantize( z ) );
+}
+
+/**
+ * Return the permutation that sorts the points along a Morton curve spanning
+ * their bounding box: the k-th point along the curve is the point
+ * permutation(k). The points may have up to three coordinates.
+ */
+template <typename DeviceType>
+Kokkos::View<int *, DeviceType>
+computeMortonPermutation( Kokkos::View<Coordinate const **, DeviceType> points )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    int const n_points = points.extent( 0 );
+    int const n_dims = points.extent( 1 );
+    DTK_REQUIRE( n_dims <= 3 );
+
+    Kokkos::View<int *, DeviceType> permutation( "permutation", n_points );
+    if ( n_points == 0 )
+        return permutation;
+
+    // Scale the bounding box of the points to the unit cube. The missing
+    // coordinates and the flat directions are set to zero.
+    Kokkos::Array<double, 3> min_corner = {{0., 0., 0.}};
+    Kokkos::Array<double, 3> scaling = {{0., 0., 0.}};
+    for ( int d = 0; d < n_dims; ++d )
+    {
+        Kokkos::MinMaxScalar<double> range;
+        Kokkos::parallel_reduce(
+            DTK_MARK_REGION( "bounding_box" ),
+            Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+            KOKKOS_LAMBDA( int const i,
+                           Kokkos::MinMaxScalar<double> &update ) {
+                double const x = points( i, d );
+                if ( x < update.min_val )
+                    update.min_val = x;
+                if ( x > update.max_val )
+                    update.max_val = x;
+            },
+            Kokkos::MinMax<double>( range ) );
+        min_corner[d] = range.min_val;
+        if ( range.max_val > range.min_val )
+            scaling[d] = 1. / ( range.max_val - range.min_val );
+    }
+
+    Kokkos::View<unsigned int *, DeviceType> codes( "morton_codes", n_points );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "compute_morton_codes" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_points ),
+        KOKKOS_LAMBDA( int const i ) {
+            double x[3] = {0., 0., 0.};
+            for ( int d = 0; d < n_dims; ++d )
+                x[d] = scaling[d] * ( points( i, d ) - min_corner[d] );
+            codes( i ) = morton3D( x[0], x[1], x[2] );
+        } );
+    Kokkos::fence();
+
+    // The codes are sorted within the bins so the order is exact.
+    using CodeView = Kokkos::View<unsigned int *, DeviceType>;
+    using BinOp = Kokkos::BinOp1D<CodeView>;
+    Kokkos::BinSort<CodeView, BinOp, DeviceType, int> bin_sort(
+        codes, BinOp( n_points, 0u, ( 1u << 30 ) - 1 ), true );
+    bin_sort.create_permute_vector();
+    Kokkos::deep_copy( permutation, bin_sort.get_permute_vector() );
+
+    return permutation;
+}
+
+/**
+ * Return a copy of \p view whose row k is the row permutation(k) of \p view.
+ */
+template <typename DeviceType, typename View>
+Kokkos::View<typename View::non_const_data_type, typename View::array_layout,
+             DeviceType>
+permuteRows( Kokkos::View<int *, DeviceType> permutation, View const &view )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    static_assert( View::rank <= 2, "permuteRows() requires a rank-1 or "
+                                    "rank-2 View" );
+    DTK_REQUIRE( permutation.extent( 0 ) == view.extent( 0 ) );
+
+    Kokkos::View<typename View::non_const_data_type,
+                 typename View::array_layout, DeviceType>
+        permuted_view( Kokkos::ViewAllocateWithoutInitializing(
+                           "permuted_" + view.label() ),
+                       view.layout() );
+    int const n_rows = view.extent( 0 );
+    int const n_columns = view.extent( 1 );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "permute_rows" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_rows ),
+        KOKKOS_LAMBDA( int const k ) {
+            for ( int j = 0; j < n_columns; ++j )
+                permuted_view.access( k, j ) =
+                    view.access( permutation( k ), j );
+        } );
+    Kokkos::fence();
+
+    return permuted_view;
+}
+
+/**
+ * Reorder the results of queries that were performed in the order given by
+ * \p permutation, i.e. the query k was built from the point permutation(k),
+ * so that they follow the order of the points. The results of the query k are
+ * the entries [offset(k), offset(k+1)) of \p indices and \p ranks.
+ */
+template <typename DeviceType>
+void restoreOrder( Kokkos::View<int *, DeviceType> permutation,
+                   Kokkos::View<int *, DeviceType> &offset,
+                   Kokkos::View<int *, DeviceType> &indices,
+                   Kokkos::View<int *, DeviceType> &ranks )
+{
+    using ExecutionSpace = typename DeviceType::execution_space;
+    int const n_queries = permutation.extent( 0 );
+    DTK_REQUIRE( offset.extent_int( 0 ) == n_queries + 1 );
+    DTK_REQUIRE( indices.extent( 0 ) == ranks.extent( 0 ) );
+
+    Kokkos::View<int *, DeviceType> new_offset( offset.label(),
+                                                n_queries + 1 );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "count_results" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_queries ),
+        KOKKOS_LAMBDA( int const k ) {
+            new_offset( permutation( k ) ) = offset( k + 1 ) - offset( k );
+        } );
+    Kokkos::parallel_scan(
+        DTK_MARK_REGION( "compute_offset" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_queries + 1 ),
+        KOKKOS_LAMBDA( int const i, int &update, bool const final_pass ) {
+            int const count = new_offset( i );
+            if ( final_pass )
+                new_offset( i ) = update;
+            update += count;
+        } );
+
+    Kokkos::View<int *, DeviceType> new_indices(
+        Kokkos::ViewAllocateWithoutInitializing( indices.label() ),
+        indices.extent( 0 ) );
+    Kokkos::View<int *, DeviceType> new_ranks(
+        Kokkos::ViewAllocateWithoutInitializing( ranks.label() ),
+        ranks.extent( 0 ) );
+    Kokkos::parallel_for(
+        DTK_MARK_REGION( "restore_order" ),
+        Kokkos::RangePolicy<ExecutionSpace>( 0, n_queries ),
+        KOKKOS_LAMBDA( int const k ) {
+            int const shift = new_offset( permutation( k ) ) - offset( k );
+            for ( int j = offset( k ); j < offset( k + 1 ); ++j )
+            {
+                new_indices( j + shift ) = indices( j );
+                new_ranks( j + shift ) = ranks( j );
+            }
+        } );
+    Kokkos::fence();
+
+    offset = new_offset;
+    indices = new_indices;
+    ranks = new_ranks;
+}
+
+} // namespace Details
+} // namespace DataTransferKit
+
+#endif